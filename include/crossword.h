@@ -1,11 +1,20 @@
 #ifndef CROSSWORD_H
 #define CROSSWORD_H
 
+#include <stdatomic.h>
 #include <stdbool.h>
-#include <time.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #define MAX_WORD_LENGTH 24
-#define GRID_SIZE 15
+#ifndef GRID_SIZE
+#define GRID_SIZE 15   /* override with -DGRID_SIZE=N for poster editions */
+#endif
+
+/* Tiled generation defaults (see puzzle_generate_tiled) */
+#define TILE_SIZE_DEFAULT   15
+#define TILE_MIN_SIZE       5
+#define TILE_ROUNDS         4   /* times leftover words are re-dealt to other tiles */
 
 /* ANSI color macros (optional) */
 #define RESET   "\033[0m"
@@ -16,10 +25,54 @@
 #define CYAN    "\033[36m"
 #define BOLD    "\033[1m"
 
+/* Arena block size for per-puzzle node allocation */
+#define ARENA_BLOCK_SIZE 4096
+
+/* Solution counting stops once this many fills are found (2 = "not unique") */
+#define DLX_SOLUTION_LIMIT 2
+
+/* Layout quality (see puzzle_layout_score) and background refinement */
+#define LAYOUT_WORD_WEIGHT  100
+#define LAYOUT_CROSS_WEIGHT 10
+#define REFINE_BUDGET_SEC   2.0
+#define REFINE_LENGTH_SLACK 2   /* shuffled word order may swap words this close in length */
+#define REFINE_REPAIR_SHARE 0.5 /* last part of the budget repairs instead of restarting */
+
+/* Neighbourhood repair */
+#define REPAIR_NEIGHBOURHOOD_DEFAULT 3
+#define REPAIR_MAX_NEIGHBOURHOOD     8
+#define REPAIR_CANDIDATES            48  /* unused dictionary words tried per refill */
+
+/* Transposition table for search-based generators (see ttable.c) */
+#define TT_ENTRIES_DEFAULT   (1u << 16)
+#define TT_DEAD_VISITS       4   /* prefix tried this often without improving -> dead */
+#define TT_MIN_PRUNE_DEPTH   3   /* never prune shallower prefixes (keeps seeds alive) */
+#define TT_FLAG_DEAD         1   /* state known to be unusable, whatever its score */
+
+/* Latency histograms: log2 buckets split into 2^HIST_SUB_BITS linear sub-buckets */
+#define HIST_SUB_BITS   4
+#define HIST_SUB_COUNT  (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS    (64 << HIST_SUB_BITS)
+
+/* Puzzles per block in the columnar archive (see archive.c) */
+#define ARCHIVE_BLOCK_PUZZLES 256
+
+/* Co-op sessions */
+#define COOP_FEED_SIZE   1024   /* change feed ring slots (power of two) */
+#define COOP_MAX_PLAYERS 255    /* players at once; ids travel in 8 bits, reused */
+
 /* Owner bitmask flags */
 #define OWNER_ACROSS 1
 #define OWNER_DOWN   2
 
+/* Bump arena: nodes are never freed one by one, only reset or torn down together */
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct {
+    ArenaBlock *head;
+    ArenaBlock *cur;
+} Arena;
+
 /* Word position metadata (one per placed word) */
 typedef struct {
     char word[MAX_WORD_LENGTH];
@@ -27,6 +80,7 @@ typedef struct {
     char direction; /* 'A' or 'D' */
     int clue_num;
     bool hint_used;
+    long long solved_ns;  /* time from start to first solve, 0 = not yet */
 } WordPos;
 
 /* Linked list node for placed words */
@@ -52,6 +106,8 @@ typedef struct MoveStackNode {
 typedef struct {
     MoveStackNode *top;
     int size;
+    MoveStackNode *free_list;   /* popped nodes, reused by push_move */
+    Arena *arena;               /* node source; NULL = malloc/free */
 } MoveStack;
 
 /* BST node for storing dictionary words */
@@ -61,48 +117,209 @@ typedef struct BSTNode {
     struct BSTNode *right;
 } BSTNode;
 
+/* Immutable dictionary shared by puzzles and threads; freed when the last reference goes */
+typedef struct {
+    Arena arena;          /* BST nodes */
+    BSTNode *root;
+    char **by_length;     /* every word, longest first (generator order) */
+    int count;
+    atomic_int refs;
+} DictSnapshot;
+
+/* Holder of the current snapshot, hot-swappable (opaque) */
+typedef struct DictStore DictStore;
+
+/* Transposition table entry: one known grid state (by Zobrist hash) */
+typedef struct {
+    uint64_t key;         /* 0 = empty slot */
+    int best;             /* best final layout score reached from this state */
+    int visits;
+    unsigned char flags;  /* TT_FLAG_* */
+} TTEntry;
+
+/* Bounded table of 2-entry buckets */
+typedef struct {
+    TTEntry *slots;
+    size_t mask;          /* slot count - 1 (power of two) */
+} TransTable;
+
+/* HDR-style latency histogram (nanoseconds) */
+typedef struct {
+    uint64_t counts[HIST_BUCKETS];
+    uint64_t total, sum, min, max;
+} LatencyHist;
+
+typedef enum {
+    TELE_INPUT_ANSWER,
+    TELE_GIVE_HINT,
+    TELE_UNDO,
+    TELE_DRAW_GRID,
+    TELE_OP_COUNT
+} TelemetryOp;
+
+/* Per-session gameplay telemetry */
+typedef struct {
+    LatencyHist ops[TELE_OP_COUNT];
+    LatencyHist word_solve;
+    int hints_used;
+    int words_solved;
+    int words_solved_with_hints;
+} Telemetry;
+
 /* Puzzle object */
 typedef struct {
     char sol[GRID_SIZE][GRID_SIZE];     /* solution letters */
     char user[GRID_SIZE][GRID_SIZE];    /* user view */
     unsigned char owner[GRID_SIZE][GRID_SIZE]; /* ownership bits */
     WordNode *positions_head;           /* linked list head for WordPos */
+    WordNode *positions_tail;           /* last node, for O(1) append */
     int word_count;
     int clue_counter;
-    time_t start_time;
+    long long start_ns;                 /* monotonic start, for the timer and telemetry */
+    uint64_t hash;                      /* Zobrist hash of sol, kept incrementally */
 
     /* data-structures: undo stack and BST dictionary root */
     MoveStack undo_stack;
-    BSTNode *dict_root;
+    bool played;                        /* any move made since the layout was built (stays set after undo) */
+    DictSnapshot *dict;                 /* shared, one reference held */
+
+    /* node storage for word/move nodes, reset per generation */
+    Arena arena;
+
+    Telemetry *telemetry;               /* NULL for internal scratch puzzles */
 } Puzzle;
 
+/* Result of scoring one user grid (see score.c) */
+typedef struct {
+    float completion;        /* % of letter cells correct, as puzzle_completion */
+    bool solved;             /* as puzzle_solved */
+    int cells_total, cells_correct;
+    int words_total, words_correct;
+    unsigned char *word_ok;  /* optional caller buffer: 1 per correct word, clue order */
+} PuzzleScore;
+
+/* Result of puzzle_unplace_word */
+typedef enum {
+    UNPLACE_NOT_FOUND,   /* no such clue; nothing changed */
+    UNPLACE_OK,          /* removed; the layout still follows the placement rules */
+    UNPLACE_TOUCHING     /* removed, but two remaining words now touch where it joined them */
+} UnplaceResult;
+
+/* Background layout refiner (opaque) */
+typedef struct Refiner Refiner;
+
+/* Columnar puzzle archive (opaque) */
+typedef struct ArchiveWriter ArchiveWriter;
+typedef struct ArchiveReader ArchiveReader;
+
+/* Co-op session: many threads solving one Puzzle (opaque) */
+typedef struct CoopSession CoopSession;
+typedef struct CoopPlayer CoopPlayer;
+
+/* One cell change from the co-op feed. Events for a cell can arrive out of
+   order; keep the one with the highest version. */
+typedef struct {
+    int row, col;
+    char letter;
+    int player;
+    unsigned version;    /* 24-bit, wraps */
+} CoopEvent;
+
+typedef enum {
+    COOP_FEED_EMPTY,     /* nothing new yet */
+    COOP_FEED_EVENT,     /* *ev filled in */
+    COOP_FEED_LOST       /* fell behind; redraw from the cells */
+} CoopFeedStatus;
+
+/* Per-observer read position in the change feed */
+typedef struct {
+    uint64_t cursor;
+} CoopObserver;
+
 /* Platform helpers */
 void clear_screen(void);
+long long monotonic_ns(void);
+unsigned long long rng_next(unsigned long long *s);
+int online_cpus(void);
 
 /* Utilities */
 void safe_gets(char *buf, int size);
 void to_upper_inplace(char *s);
 
 /* Puzzle lifecycle */
-Puzzle *puzzle_create(void);
+Puzzle *puzzle_create(DictSnapshot *dict);   /* NULL = private default dictionary */
 void puzzle_free(Puzzle *p);
+void puzzle_set_dictionary(Puzzle *p, DictSnapshot *dict);
 bool puzzle_init(Puzzle *p);
 void puzzle_create_user_grid(Puzzle *p);
 
-/* Dictionary BST */
-BSTNode *bst_insert(BSTNode *root, const char *word);
-void bst_free(BSTNode *root);
+/* Arena allocator */
+void arena_init(Arena *a);
+void *arena_alloc(Arena *a, size_t size);
+void arena_reset(Arena *a);
+void arena_free(Arena *a);
+
+/* Dictionary BST (nodes live in an arena, released with it) */
+BSTNode *bst_new_node(Arena *a, const char *word);
+BSTNode *bst_insert(Arena *a, BSTNode *root, const char *word);
 int bst_count(BSTNode *root);
+bool bst_contains(const BSTNode *root, const char *word);
 void bst_inorder_collect(BSTNode *root, char **out, int *idx, int max);
 
+/* Dictionary snapshots and store (readers never block on reload) */
+DictSnapshot *dict_snapshot_build(const char *const *words, int n);
+DictSnapshot *dict_snapshot_default(void);
+DictSnapshot *dict_snapshot_load_file(const char *path);
+void dict_snapshot_retain(DictSnapshot *d);
+void dict_snapshot_release(DictSnapshot *d);
+DictStore *dict_store_create(DictSnapshot *initial);
+DictSnapshot *dict_store_acquire(DictStore *s);
+void dict_store_publish(DictStore *s, DictSnapshot *snap);
+bool dict_store_reload_async(DictStore *s, const char *path);
+void dict_store_free(DictStore *s);
+
 /* Generation */
-bool puzzle_generate_from_bst(Puzzle *p); /* new: uses BST as source */
+bool puzzle_generate_from_bst(Puzzle *p); /* uses the puzzle's dictionary snapshot */
 bool puzzle_generate(Puzzle *p, char **words, int count);
+bool puzzle_generate_tiled(Puzzle *p, char **words, int count, int tile_size, int threads); /* threads < 1: online CPUs */
+int cmp_len_desc(const void *a, const void *b);
 
 /* Placement */
 bool puzzle_can_place(Puzzle *p, const char *w, int r, int c, char d);
 bool puzzle_place_word_record(Puzzle *p, const char *w, int r, int c, char d);
 int puzzle_find_intersection(Puzzle *p, const char *w, int *out_r, int *out_c, char *out_d);
+uint64_t puzzle_stamp_word(Puzzle *p, const char *w, int r, int c, char d);
+UnplaceResult puzzle_unplace_word(Puzzle *p, int clue, char d);
+uint64_t zobrist_key(int r, int c, char ch);
+bool puzzle_append_record(Puzzle *p, const char *w, int r, int c, char d);
+bool puzzle_place_anywhere(Puzzle *p, const char *w);
+
+/* Anytime generation: play the greedy grid now, adopt better layouts until a deadline.
+   The refiner holds its own dictionary reference. */
+int puzzle_layout_score(const Puzzle *p);
+bool puzzle_copy_layout(Puzzle *dst, const Puzzle *src);
+bool puzzle_started(const Puzzle *p);
+Refiner *puzzle_refine_start(Puzzle *p, double budget_sec);
+bool puzzle_refine_poll(Refiner *rf, Puzzle *p);
+void puzzle_refine_stop(Refiner *rf);
+bool puzzle_repair(Puzzle *p, double budget_sec, int neighbourhood);
+
+/* Transposition table */
+TransTable *tt_create(size_t entries);
+void tt_free(TransTable *tt);
+const TTEntry *tt_probe(const TransTable *tt, uint64_t key);
+void tt_record(TransTable *tt, uint64_t key, int score);
+void tt_mark_dead(TransTable *tt, uint64_t key);
+bool tt_is_dead(const TransTable *tt, uint64_t key, int best_so_far);
+
+/* Puzzle archive: compact catalogue with random access by puzzle number */
+ArchiveWriter *archive_writer_open(const char *path);
+bool archive_writer_append(ArchiveWriter *w, const Puzzle *p);
+bool archive_writer_close(ArchiveWriter *w);
+ArchiveReader *archive_reader_open(const char *path);
+long archive_reader_count(const ArchiveReader *r);
+bool archive_reader_read(ArchiveReader *r, long index, Puzzle *out);
+void archive_reader_close(ArchiveReader *r);
 
 /* Rendering */
 void draw_grid(const Puzzle *p, bool solution_view);
@@ -117,12 +334,38 @@ void push_move(MoveStack *s, Move mv);
 bool pop_move(MoveStack *s, Move *out);
 void undo_last_move(Puzzle *p);
 
+/* Solution counting (dancing links) */
+int puzzle_count_solutions(const Puzzle *p, char **words, int count, int limit);
+int puzzle_solution_count(Puzzle *p);
+bool puzzle_has_unique_solution(Puzzle *p);
+bool puzzle_fill_valid(const Puzzle *p);
+
+/* Telemetry */
+Telemetry *telemetry_create(void);
+void telemetry_free(Telemetry *t);
+void telemetry_record(Telemetry *t, TelemetryOp op, long long ns);
+void telemetry_note_progress(Puzzle *p);
+bool telemetry_export(const Puzzle *p, const char *path);
+void hist_record(LatencyHist *h, uint64_t v);
+uint64_t hist_quantile(const LatencyHist *h, double q);
+
+/* Co-op solving (lock-free; see coop.c) */
+CoopSession *coop_create(Puzzle *p);
+void coop_free(CoopSession *s);
+void coop_sync_to_puzzle(CoopSession *s);
+CoopPlayer *coop_join(CoopSession *s);
+void coop_leave(CoopPlayer *pl);
+int coop_player_id(const CoopPlayer *pl);
+bool coop_input_answer(CoopPlayer *pl, int clue, char d, const char *ans);
+bool coop_give_hint(CoopPlayer *pl, int clue, char d);
+bool coop_undo(CoopPlayer *pl);
+void coop_observe(CoopSession *s, CoopObserver *o);
+CoopFeedStatus coop_feed_next(CoopSession *s, CoopObserver *o, CoopEvent *ev);
+
 /* Progress / timer */
 bool puzzle_solved(const Puzzle *p);
 float puzzle_completion(const Puzzle *p);
+void puzzle_score_batch(const Puzzle *const *ps, int n, PuzzleScore *out);
 void show_timer(const Puzzle *p);
 
-/* Extra helpers for BST population (default words) */
-void populate_default_dictionary(Puzzle *p);
-
 #endif /* CROSSWORD_H */
@@ -19,25 +19,40 @@ void show_title(void) {
 
 int main(void) {
     srand((unsigned)time(NULL));
-    Puzzle *p = puzzle_create();
-    if (!p) { fprintf(stderr, "Failed to allocate puzzle\n"); return 1; }
+    /* one shared dictionary snapshot for every puzzle in this process */
+    DictStore *dict = dict_store_create(dict_snapshot_default());
+    if (!dict) { fprintf(stderr, "Failed to build dictionary\n"); return 1; }
+    DictSnapshot *snap = dict_store_acquire(dict);
+    Puzzle *p = puzzle_create(snap);
+    dict_snapshot_release(snap);
+    if (!p) { fprintf(stderr, "Failed to allocate puzzle\n"); dict_store_free(dict); return 1; }
 
     clear_screen();
     show_title();
 
-    /* Generate puzzle from BST dictionary (uses BST -> array -> generator) */
+    /* Generate puzzle from the dictionary snapshot (BST -> length-sorted array -> generator) */
     if (!puzzle_generate_from_bst(p)) {
         fprintf(stderr, "Failed to generate puzzle\n");
         puzzle_free(p);
+        dict_store_free(dict);
         return 1;
     }
 
     printf("%sGenerated with %d placed words.%s\n", GREEN, p->word_count, RESET);
+    int fills = puzzle_solution_count(p);
+
+    /* keep improving the layout in the background until the first move */
+    Refiner *rf = puzzle_refine_start(p, REFINE_BUDGET_SEC);
 
     char buf[256];
     for (;;) {
+        /* an adopted layout has different clues; check uniqueness again */
+        if (puzzle_refine_poll(rf, p)) fills = puzzle_solution_count(p);
         clear_screen();
         show_title();
+        /* 0 only means the dictionary could not confirm the answers */
+        if (fills >= 2)
+            printf("%sNote: more than one fill matches these clues; any valid fill is accepted.%s\n", YELLOW, RESET);
         printf("%s\n--- MENU ---\n%s", BOLD, RESET);
         printf("1. View puzzle (game view)\n");
         printf("2. View clues\n");
@@ -124,6 +139,13 @@ int main(void) {
         }
     }
 
+    /* optional telemetry dump (Prometheus text format) */
+    const char *metrics = getenv("PESUZZLE_METRICS");
+    if (metrics && !telemetry_export(p, metrics))
+        fprintf(stderr, "Could not write metrics to %s\n", metrics);
+
+    puzzle_refine_stop(rf);
     puzzle_free(p);
+    dict_store_free(dict);
     return 0;
 }
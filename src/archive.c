@@ -0,0 +1,481 @@
+/* src/archive.c
+ *
+ * Compact columnar archive for large catalogues of generated puzzles.
+ *
+ * Only the solution layout is stored; user/owner grids and the word list are
+ * rebuilt on load. Puzzles are grouped into blocks of ARCHIVE_BLOCK_PUZZLES,
+ * and inside a block each field is stored as its own column:
+ *
+ *   block   := u32 n
+ *              u32 letters_off[n+1]   offsets into the letters column
+ *              u32 words_off[n+1]     offsets into the words column
+ *              bitmap column          n * ceil(G*G/8) bytes, occupied cells
+ *              letters column         5-bit letters of occupied cells, row-major
+ *              words column           varint count, then per word
+ *                                     varint(zigzag(start - prev_start) << 1 | down)
+ *
+ * Word lengths are not stored: a word runs from its start until the next
+ * blank cell. The placement rules guarantee that, and the writer checks it
+ * for every word (refusing the puzzle otherwise), so every record it writes
+ * decodes to the same words. Reading stamps those words back without the
+ * placement checks; a layout left with touching words by
+ * puzzle_unplace_word therefore round-trips unchanged. Words keep their
+ * list order, so clue numbers come back in the same order (renumbered from
+ * 1 if words had been removed).
+ *
+ * The file ends with a block index (u64 offset per block) and a 16-byte
+ * trailer, so puzzle i is read by seeking to its block and fetching only
+ * its own slice of each column.
+ *
+ * All integers are little-endian.
+ */
+
+#include "../include/crossword.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARCHIVE_MAGIC       "PZAR"
+#define ARCHIVE_INDEX_MAGIC "PZIX"
+#define ARCHIVE_VERSION     1
+#define ARCHIVE_HEADER_SIZE 12
+#define ARCHIVE_TRAILER_SIZE 16
+#define BITMAP_BYTES        ((GRID_SIZE * GRID_SIZE + 7) / 8)
+
+/* ----------------- Byte buffers and file helpers ----------------- */
+
+typedef struct {
+    unsigned char *data;
+    size_t len, cap;
+} ByteBuf;
+
+static bool buf_reserve(ByteBuf *b, size_t extra) {
+    if (b->len + extra <= b->cap) return true;
+    size_t cap = b->cap ? b->cap : 256;
+    while (cap < b->len + extra) cap *= 2;
+    unsigned char *d = (unsigned char *) realloc(b->data, cap);
+    if (!d) return false;
+    b->data = d;
+    b->cap = cap;
+    return true;
+}
+
+static bool buf_put(ByteBuf *b, const void *src, size_t n) {
+    if (!buf_reserve(b, n)) return false;
+    memcpy(b->data + b->len, src, n);
+    b->len += n;
+    return true;
+}
+
+static bool buf_varint(ByteBuf *b, uint32_t v) {
+    unsigned char tmp[5];
+    size_t n = 0;
+    do {
+        unsigned char byte = v & 0x7F;
+        v >>= 7;
+        tmp[n++] = byte | (v ? 0x80 : 0);
+    } while (v);
+    return buf_put(b, tmp, n);
+}
+
+static void put_u32(unsigned char *dst, uint32_t v) {
+    for (int i = 0; i < 4; ++i) dst[i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint32_t get_u32(const unsigned char *src) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) v |= (uint32_t)src[i] << (8 * i);
+    return v;
+}
+
+static void put_u64(unsigned char *dst, uint64_t v) {
+    for (int i = 0; i < 8; ++i) dst[i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint64_t get_u64(const unsigned char *src) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v |= (uint64_t)src[i] << (8 * i);
+    return v;
+}
+
+/* 64-bit file positions (long is 32-bit on Windows) */
+static bool file_seek(FILE *f, uint64_t off) {
+#ifdef _WIN32
+    return _fseeki64(f, (long long)off, SEEK_SET) == 0;
+#else
+    return fseeko(f, (off_t)off, SEEK_SET) == 0;
+#endif
+}
+
+static uint64_t file_tell(FILE *f) {
+#ifdef _WIN32
+    return (uint64_t)_ftelli64(f);
+#else
+    return (uint64_t)ftello(f);
+#endif
+}
+
+static bool read_at(FILE *f, uint64_t off, void *dst, size_t n) {
+    return file_seek(f, off) && fread(dst, 1, n, f) == n;
+}
+
+/* ----------------- Writer ----------------- */
+
+struct ArchiveWriter {
+    FILE *f;
+    uint64_t *block_offsets;
+    uint32_t block_count, block_cap;
+    uint64_t total;
+    /* current block, one buffer per column */
+    uint32_t n;
+    uint32_t letters_off[ARCHIVE_BLOCK_PUZZLES + 1];
+    uint32_t words_off[ARCHIVE_BLOCK_PUZZLES + 1];
+    ByteBuf bitmap, letters, words;
+};
+
+ArchiveWriter *archive_writer_open(const char *path) {
+    if (!path) return NULL;
+    ArchiveWriter *w = (ArchiveWriter *) calloc(1, sizeof(ArchiveWriter));
+    if (!w) return NULL;
+    w->f = fopen(path, "wb");
+    if (!w->f) { free(w); return NULL; }
+    unsigned char hdr[ARCHIVE_HEADER_SIZE] = {0};
+    memcpy(hdr, ARCHIVE_MAGIC, 4);
+    hdr[4] = ARCHIVE_VERSION;
+    hdr[6] = (unsigned char)(GRID_SIZE & 0xFF);
+    hdr[7] = (unsigned char)(GRID_SIZE >> 8);
+    put_u32(hdr + 8, ARCHIVE_BLOCK_PUZZLES);
+    if (fwrite(hdr, 1, sizeof(hdr), w->f) != sizeof(hdr)) {
+        fclose(w->f);
+        free(w);
+        return NULL;
+    }
+    return w;
+}
+
+static bool writer_flush_block(ArchiveWriter *w) {
+    if (w->n == 0) return true;
+    if (w->block_count == w->block_cap) {
+        uint32_t cap = w->block_cap ? w->block_cap * 2 : 64;
+        uint64_t *grown = (uint64_t *) realloc(w->block_offsets, cap * sizeof(uint64_t));
+        if (!grown) return false;
+        w->block_offsets = grown;
+        w->block_cap = cap;
+    }
+    w->block_offsets[w->block_count++] = file_tell(w->f);
+
+    size_t head_len = 4 + 2 * 4 * (size_t)(w->n + 1);
+    unsigned char *head = (unsigned char *) malloc(head_len);
+    if (!head) return false;
+    put_u32(head, w->n);
+    for (uint32_t i = 0; i <= w->n; ++i) {
+        put_u32(head + 4 + 4 * i, w->letters_off[i]);
+        put_u32(head + 4 + 4 * (w->n + 1) + 4 * i, w->words_off[i]);
+    }
+    bool ok = fwrite(head, 1, head_len, w->f) == head_len
+           && fwrite(w->bitmap.data, 1, w->bitmap.len, w->f) == w->bitmap.len
+           && fwrite(w->letters.data, 1, w->letters.len, w->f) == w->letters.len
+           && fwrite(w->words.data, 1, w->words.len, w->f) == w->words.len;
+    free(head);
+    w->n = 0;
+    w->bitmap.len = w->letters.len = w->words.len = 0;
+    return ok;
+}
+
+static uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+/* Each word must match the grid and end at a blank cell or the edge, so
+   the reader recovers it from the letter run alone */
+static bool words_decodable(const Puzzle *p) {
+    for (const WordNode *cur = p->positions_head; cur; cur = cur->next) {
+        const WordPos *wp = &cur->data;
+        int L = (int)strlen(wp->word);
+        int dr = (wp->direction == 'D'), dc = (wp->direction == 'A');
+        if (L <= 0 || (!dr && !dc) || wp->row < 0 || wp->col < 0) return false;
+        int er = wp->row + dr * L, ec = wp->col + dc * L;   /* cell after the end */
+        if (er - dr >= GRID_SIZE || ec - dc >= GRID_SIZE) return false;
+        for (int k = 0; k < L; ++k)
+            if (p->sol[wp->row + dr * k][wp->col + dc * k] != wp->word[k]) return false;
+        if (er < GRID_SIZE && ec < GRID_SIZE && p->sol[er][ec] != ' ') return false;
+    }
+    return true;
+}
+
+bool archive_writer_append(ArchiveWriter *w, const Puzzle *p) {
+    if (!w || !p || !words_decodable(p)) return false;
+    size_t bitmap_start = w->bitmap.len, letters_start = w->letters.len, words_start = w->words.len;
+    bool ok = true;
+
+    /* occupancy bitmap and 5-bit letters */
+    unsigned char bitmap[BITMAP_BYTES] = {0};
+    uint32_t acc = 0;
+    int bits = 0;
+    for (int r = 0; r < GRID_SIZE && ok; ++r)
+        for (int c = 0; c < GRID_SIZE && ok; ++c) {
+            char ch = p->sol[r][c];
+            if (ch == ' ') continue;
+            if (ch < 'A' || ch > 'Z') { ok = false; break; }
+            int cell = r * GRID_SIZE + c;
+            bitmap[cell >> 3] |= (unsigned char)(1u << (cell & 7));
+            acc |= (uint32_t)(ch - 'A' + 1) << bits;
+            bits += 5;
+            while (bits >= 8 && ok) {
+                unsigned char byte = (unsigned char)(acc & 0xFF);
+                ok = buf_put(&w->letters, &byte, 1);
+                acc >>= 8;
+                bits -= 8;
+            }
+        }
+    if (ok && bits > 0) {
+        unsigned char byte = (unsigned char)(acc & 0xFF);
+        ok = buf_put(&w->letters, &byte, 1);
+    }
+    if (ok) ok = buf_put(&w->bitmap, bitmap, sizeof(bitmap));
+
+    /* word starts, delta coded in clue order, direction in the low bit */
+    if (ok) ok = buf_varint(&w->words, (uint32_t)p->word_count);
+    int prev = 0;
+    for (const WordNode *cur = p->positions_head; cur && ok; cur = cur->next) {
+        int start = cur->data.row * GRID_SIZE + cur->data.col;
+        uint32_t v = zigzag(start - prev) << 1 | (cur->data.direction == 'D');
+        ok = buf_varint(&w->words, v);
+        prev = start;
+    }
+    if (!ok) {
+        /* drop the partial record so the block stays consistent */
+        w->bitmap.len = bitmap_start;
+        w->letters.len = letters_start;
+        w->words.len = words_start;
+        return false;
+    }
+
+    w->letters_off[w->n] = (uint32_t)letters_start;
+    w->words_off[w->n] = (uint32_t)words_start;
+    w->n++;
+    w->letters_off[w->n] = (uint32_t)w->letters.len;
+    w->words_off[w->n] = (uint32_t)w->words.len;
+    w->total++;
+    if (w->n == ARCHIVE_BLOCK_PUZZLES) return writer_flush_block(w);
+    return true;
+}
+
+/* Flush the last block and write the block index; frees the writer */
+bool archive_writer_close(ArchiveWriter *w) {
+    if (!w) return false;
+    bool ok = writer_flush_block(w);
+    unsigned char b8[8];
+    for (uint32_t i = 0; ok && i < w->block_count; ++i) {
+        put_u64(b8, w->block_offsets[i]);
+        ok = fwrite(b8, 1, 8, w->f) == 8;
+    }
+    unsigned char trailer[ARCHIVE_TRAILER_SIZE];
+    put_u64(trailer, w->total);
+    put_u32(trailer + 8, w->block_count);
+    memcpy(trailer + 12, ARCHIVE_INDEX_MAGIC, 4);
+    if (ok) ok = fwrite(trailer, 1, sizeof(trailer), w->f) == sizeof(trailer);
+    if (fclose(w->f) != 0) ok = false;
+    free(w->block_offsets);
+    free(w->bitmap.data);
+    free(w->letters.data);
+    free(w->words.data);
+    free(w);
+    return ok;
+}
+
+/* ----------------- Reader ----------------- */
+
+struct ArchiveReader {
+    FILE *f;
+    uint64_t *block_offsets;
+    uint32_t block_count;
+    uint32_t block_puzzles;
+    uint64_t total;
+};
+
+ArchiveReader *archive_reader_open(const char *path) {
+    if (!path) return NULL;
+    ArchiveReader *r = (ArchiveReader *) calloc(1, sizeof(ArchiveReader));
+    if (!r) return NULL;
+    r->f = fopen(path, "rb");
+    if (!r->f) { free(r); return NULL; }
+
+    unsigned char hdr[ARCHIVE_HEADER_SIZE], trailer[ARCHIVE_TRAILER_SIZE];
+    bool ok = read_at(r->f, 0, hdr, sizeof(hdr))
+           && memcmp(hdr, ARCHIVE_MAGIC, 4) == 0
+           && hdr[4] == ARCHIVE_VERSION
+           && (hdr[6] | hdr[7] << 8) == GRID_SIZE;
+    if (ok) {
+        r->block_puzzles = get_u32(hdr + 8);
+        ok = r->block_puzzles > 0
+          && fseek(r->f, -(long)ARCHIVE_TRAILER_SIZE, SEEK_END) == 0
+          && fread(trailer, 1, sizeof(trailer), r->f) == sizeof(trailer)
+          && memcmp(trailer + 12, ARCHIVE_INDEX_MAGIC, 4) == 0;
+    }
+    if (ok) {
+        r->total = get_u64(trailer);
+        r->block_count = get_u32(trailer + 8);
+        uint64_t index_off = file_tell(r->f) - ARCHIVE_TRAILER_SIZE - 8ULL * r->block_count;
+        r->block_offsets = (uint64_t *) malloc(sizeof(uint64_t) * (r->block_count ? r->block_count : 1));
+        ok = r->block_offsets != NULL && file_seek(r->f, index_off);
+        unsigned char b8[8];
+        for (uint32_t i = 0; ok && i < r->block_count; ++i) {
+            ok = fread(b8, 1, 8, r->f) == 8;
+            if (ok) r->block_offsets[i] = get_u64(b8);
+        }
+    }
+    if (!ok) {
+        archive_reader_close(r);
+        return NULL;
+    }
+    return r;
+}
+
+long archive_reader_count(const ArchiveReader *r) {
+    return r ? (long)r->total : 0;
+}
+
+static bool decode_varint(const unsigned char **pp, const unsigned char *end, uint32_t *out) {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35 && *pp < end; shift += 7) {
+        unsigned char byte = *(*pp)++;
+        v |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) { *out = v; return true; }
+    }
+    return false;
+}
+
+typedef struct {
+    int row, col;
+    char d;
+} WordStart;
+
+/* Letters from a word start up to the next empty cell, copied into word
+   (NUL-terminated) unless it is NULL. Returns the length; MAX_WORD_LENGTH
+   means the run is too long to be a word. */
+static int letter_run(char (*grid)[GRID_SIZE], const WordStart *ws, char *word) {
+    int L = 0;
+    while (L < MAX_WORD_LENGTH) {
+        int rr = ws->row + (ws->d == 'D' ? L : 0), cc = ws->col + (ws->d == 'A' ? L : 0);
+        if (rr >= GRID_SIZE || cc >= GRID_SIZE || grid[rr][cc] == 0) break;
+        if (word && L < MAX_WORD_LENGTH - 1) word[L] = grid[rr][cc];
+        L++;
+    }
+    if (word && L < MAX_WORD_LENGTH) word[L] = '\0';
+    return L;
+}
+
+/* Load puzzle `index` into out (replacing its layout); reads only that
+   puzzle's slices. On a corrupt or truncated record out is left unchanged. */
+bool archive_reader_read(ArchiveReader *r, long index, Puzzle *out) {
+    if (!r || !out || index < 0 || (uint64_t)index >= r->total) return false;
+    uint32_t block = (uint32_t)(index / r->block_puzzles);
+    uint32_t slot = (uint32_t)(index % r->block_puzzles);
+    if (block >= r->block_count) return false;
+    uint64_t base = r->block_offsets[block];
+
+    unsigned char b4[4], lo[8], wo[8];
+    if (!read_at(r->f, base, b4, 4)) return false;
+    uint32_t n = get_u32(b4);
+    if (slot >= n) return false;
+    uint64_t letters_tab = base + 4;
+    uint64_t words_tab = letters_tab + 4ULL * (n + 1);
+    uint64_t bitmap_col = words_tab + 4ULL * (n + 1);
+    if (!read_at(r->f, letters_tab + 4ULL * slot, lo, 8)) return false;
+    if (!read_at(r->f, words_tab + 4ULL * slot, wo, 8)) return false;
+    uint32_t l0 = get_u32(lo), l1 = get_u32(lo + 4);
+    uint32_t w0 = get_u32(wo), w1 = get_u32(wo + 4);
+    if (!read_at(r->f, letters_tab + 4ULL * n, b4, 4)) return false;
+    uint32_t letters_total = get_u32(b4);
+    uint64_t letters_col = bitmap_col + (uint64_t)n * BITMAP_BYTES;
+    uint64_t words_col = letters_col + letters_total;
+    if (l1 < l0 || w1 < w0) return false;
+
+    unsigned char bitmap[BITMAP_BYTES];
+    unsigned char *letters = (unsigned char *) malloc((size_t)(l1 - l0) + 1);
+    unsigned char *words = (unsigned char *) malloc((size_t)(w1 - w0) + 1);
+    bool ok = letters && words
+           && read_at(r->f, bitmap_col + (uint64_t)slot * BITMAP_BYTES, bitmap, sizeof(bitmap))
+           && read_at(r->f, letters_col + l0, letters, l1 - l0)
+           && read_at(r->f, words_col + w0, words, w1 - w0);
+
+    /* unpack letters into a scratch grid */
+    char (*grid)[GRID_SIZE] = ok ? (char (*)[GRID_SIZE]) calloc(GRID_SIZE, GRID_SIZE) : NULL;
+    if (ok && !grid) ok = false;
+    if (ok) {
+        uint32_t acc = 0, pos = 0;
+        int bits = 0;
+        for (int cell = 0; ok && cell < GRID_SIZE * GRID_SIZE; ++cell) {
+            if (!(bitmap[cell >> 3] & (1u << (cell & 7)))) continue;
+            while (bits < 5 && pos < l1 - l0) { acc |= (uint32_t)letters[pos++] << bits; bits += 8; }
+            if (bits < 5) { ok = false; break; }
+            unsigned v = acc & 0x1F;
+            acc >>= 5;
+            bits -= 5;
+            if (v < 1 || v > 26) { ok = false; break; }
+            grid[cell / GRID_SIZE][cell % GRID_SIZE] = (char)('A' + v - 1);
+        }
+    }
+
+    /* decode and check the whole word column before out is touched, so a
+       corrupt record leaves out as it was */
+    WordStart *starts = NULL;
+    uint32_t count = 0;
+    if (ok) {
+        const unsigned char *wp = words, *end = words + (w1 - w0);
+        ok = decode_varint(&wp, end, &count) && count <= w1 - w0;
+        starts = ok ? (WordStart *) malloc(((size_t)count + 1) * sizeof(WordStart)) : NULL;
+        unsigned char *covered = ok ? (unsigned char *) calloc(GRID_SIZE, GRID_SIZE) : NULL;
+        if (ok && (!starts || !covered)) ok = false;
+        int start = 0;
+        for (uint32_t k = 0; ok && k < count; ++k) {
+            uint32_t v;
+            ok = decode_varint(&wp, end, &v);
+            if (!ok) break;
+            start += unzigzag(v >> 1);
+            WordStart *ws = &starts[k];
+            ws->row = start / GRID_SIZE;
+            ws->col = start % GRID_SIZE;
+            ws->d = (v & 1) ? 'D' : 'A';
+            if (start < 0 || ws->row >= GRID_SIZE) { ok = false; break; }
+            int L = letter_run(grid, ws, NULL);
+            ok = L > 0 && L < MAX_WORD_LENGTH;
+            for (int i = 0; i < L; ++i)
+                covered[(ws->row + (ws->d == 'D' ? i : 0)) * GRID_SIZE + ws->col + (ws->d == 'A' ? i : 0)] = 1;
+        }
+        /* every stored letter must belong to a word */
+        for (int cell = 0; ok && cell < GRID_SIZE * GRID_SIZE; ++cell)
+            if (grid[cell / GRID_SIZE][cell % GRID_SIZE] && !covered[cell]) ok = false;
+        free(covered);
+    }
+
+    /* rebuild words in clue order; lengths come from the letter runs, and the
+       writer already checked each record decodes, so no placement checks */
+    if (ok) ok = puzzle_init(out);
+    char word[MAX_WORD_LENGTH];
+    for (uint32_t k = 0; ok && k < count; ++k) {
+        const WordStart *ws = &starts[k];
+        (void)letter_run(grid, ws, word);
+        out->hash ^= puzzle_stamp_word(out, word, ws->row, ws->col, ws->d);
+        ok = puzzle_append_record(out, word, ws->row, ws->col, ws->d);
+    }
+    if (ok) puzzle_create_user_grid(out);
+
+    free(starts);
+    free(grid);
+    free(letters);
+    free(words);
+    return ok;
+}
+
+void archive_reader_close(ArchiveReader *r) {
+    if (!r) return;
+    if (r->f) fclose(r->f);
+    free(r->block_offsets);
+    free(r);
+}
@@ -0,0 +1,76 @@
+/* src/arena.c
+ *
+ * Bump allocator for per-puzzle nodes (dictionary, placed words, moves).
+ *
+ * Memory comes in blocks chained together. Allocation bumps an offset in the
+ * current block; reset rewinds to the first block without freeing anything,
+ * so a Puzzle can be regenerated without returning memory to the system.
+ */
+
+#include "../include/crossword.h"
+#include <stddef.h>
+#include <stdlib.h>
+
+struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t used;
+    size_t cap;
+    max_align_t data[];
+};
+
+#define ARENA_ALIGN (sizeof(max_align_t))
+
+void arena_init(Arena *a) {
+    if (!a) return;
+    a->head = NULL;
+    a->cur = NULL;
+}
+
+void *arena_alloc(Arena *a, size_t size) {
+    if (!a || size == 0) return NULL;
+    size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+    /* walk forward through blocks kept from before the last reset */
+    while (a->cur && a->cur->used + size > a->cur->cap && a->cur->next) {
+        a->cur = a->cur->next;
+        a->cur->used = 0;
+    }
+    if (!a->cur || a->cur->used + size > a->cur->cap) {
+        size_t cap = (size > ARENA_BLOCK_SIZE) ? size : ARENA_BLOCK_SIZE;
+        ArenaBlock *b = (ArenaBlock *) malloc(sizeof(ArenaBlock) + cap);
+        if (!b) return NULL;
+        b->used = 0;
+        b->cap = cap;
+        b->next = NULL;
+        if (a->cur) {
+            /* splice in after cur so blocks later in the chain stay reusable */
+            b->next = a->cur->next;
+            a->cur->next = b;
+        } else {
+            b->next = a->head;
+            a->head = b;
+        }
+        a->cur = b;
+    }
+    void *mem = (char *)a->cur->data + a->cur->used;
+    a->cur->used += size;
+    return mem;
+}
+
+/* O(1): everything allocated so far is invalidated, blocks are kept */
+void arena_reset(Arena *a) {
+    if (!a) return;
+    a->cur = a->head;
+    if (a->cur) a->cur->used = 0;
+}
+
+void arena_free(Arena *a) {
+    if (!a) return;
+    ArenaBlock *b = a->head;
+    while (b) {
+        ArenaBlock *nx = b->next;
+        free(b);
+        b = nx;
+    }
+    a->head = a->cur = NULL;
+}
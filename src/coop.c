@@ -0,0 +1,347 @@
+/* src/coop.c
+ *
+ * Co-op mode: many players solving one Puzzle at once from different threads.
+ *
+ * The layout (sol, owner, positions list) is read-only for the life of the
+ * session; only the user grid changes. Each user cell is one atomic word
+ * holding the letter and a 24-bit version, updated with compare-and-swap, so
+ * there is no lock and writers only ever contend on the same cell.
+ *
+ * Every player has a private undo history. An undo is a CAS from exactly the
+ * value that player wrote back to what was there before; if anyone has
+ * written the cell since, the undo is refused and that move is dropped
+ * (the later write wins).
+ *
+ * Player ids (1..COOP_MAX_PLAYERS) are claimed from a bitmap and returned on
+ * coop_leave, so any number of players can come and go as long as no more
+ * than COOP_MAX_PLAYERS are in the session at once.
+ *
+ * Changes are broadcast through a fixed ring that observers read with their
+ * own cursor. Writers claim a sequence number with one fetch-add and never
+ * wait for readers; a reader that falls a full ring behind is told it lost
+ * events and should redraw from the cells (coop_sync_to_puzzle).
+ *
+ * Ring slot protocol: slot.seq is 2n+1 while event n is being written and
+ * 2n+2 once it is published. A writer only claims a slot whose seq is below
+ * its own, and both event words carry the ring lap, so a writer that stalls
+ * past a whole lap cannot pass off its stale event as a newer one.
+ */
+
+#include "../include/crossword.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COOP_CELLS (GRID_SIZE * GRID_SIZE)
+#define COOP_ID_WORDS ((COOP_MAX_PLAYERS + 64) / 64)   /* bit per id, id 0 unused */
+
+_Static_assert(COOP_MAX_PLAYERS <= 0xFF, "co-op events store the player id in 8 bits");
+_Static_assert((COOP_FEED_SIZE & (COOP_FEED_SIZE - 1)) == 0, "COOP_FEED_SIZE must be a power of two");
+
+typedef struct {
+    atomic_ullong seq;
+    atomic_ullong data;          /* packed event, see pack_event */
+    atomic_ullong cell;          /* lap << 56 | cell index */
+} FeedSlot;
+
+struct CoopSession {
+    Puzzle *p;                   /* layout and solution; not modified while shared */
+    _Atomic uint32_t cells[COOP_CELLS];   /* version << 8 | letter */
+    atomic_bool *hinted;         /* per word, clue order */
+    int word_count;
+    atomic_ullong ids[COOP_ID_WORDS];     /* player ids in use */
+    atomic_int hints_used;
+    int hints_synced;            /* hints_used already added to telemetry */
+    atomic_ullong feed_head;     /* next sequence number to hand out */
+    FeedSlot feed[COOP_FEED_SIZE];
+};
+
+typedef struct {
+    int cell;
+    uint32_t was;                /* full cell value this player overwrote */
+    uint32_t wrote;              /* full cell value this player left behind */
+} CoopMove;
+
+struct CoopPlayer {
+    CoopSession *s;
+    int id;
+    unsigned long long rng;      /* hint choice, see rng_next */
+    CoopMove *moves;             /* undo history, owned by this player's thread */
+    int move_count, move_cap;
+};
+
+/* ----------------- Cells ----------------- */
+
+static char cell_letter(uint32_t v) { return (char)(v & 0xFF); }
+static uint32_t cell_version(uint32_t v) { return v >> 8; }
+static uint32_t cell_pack(uint32_t version, char ch) {
+    return (version & 0xFFFFFFu) << 8 | (unsigned char)ch;
+}
+
+/* ----------------- Change feed ----------------- */
+
+static uint64_t feed_lap(uint64_t seq) { return (seq / COOP_FEED_SIZE) & 0xFF; }
+
+/* The cell index has its own slot word so grids of any size fit; both
+   words carry the lap, and a reader accepts the event only if they agree */
+static uint64_t pack_event(uint64_t seq, char ch, int player, uint32_t version) {
+    return (uint64_t)(unsigned char)ch
+         | (uint64_t)(player & 0xFF) << 8
+         | (uint64_t)(version & 0xFFFFFFu) << 16
+         | feed_lap(seq) << 56;
+}
+
+static uint64_t pack_cell(uint64_t seq, int cell) {
+    return (uint64_t)(uint32_t)cell | feed_lap(seq) << 56;
+}
+
+static void feed_publish(CoopSession *s, int cell, char ch, int player, uint32_t version) {
+    uint64_t seq = atomic_fetch_add(&s->feed_head, 1);
+    FeedSlot *slot = &s->feed[seq & (COOP_FEED_SIZE - 1)];
+    uint64_t cur = atomic_load(&slot->seq);
+    do {
+        if (cur > 2 * seq) return;   /* a later lap owns the slot; readers see a gap */
+    } while (!atomic_compare_exchange_weak(&slot->seq, &cur, 2 * seq + 1));
+    atomic_store(&slot->cell, pack_cell(seq, cell));
+    atomic_store(&slot->data, pack_event(seq, ch, player, version));
+    uint64_t writing = 2 * seq + 1;
+    (void)atomic_compare_exchange_strong(&slot->seq, &writing, 2 * seq + 2);
+}
+
+void coop_observe(CoopSession *s, CoopObserver *o) {
+    if (!s || !o) return;
+    o->cursor = atomic_load(&s->feed_head);
+}
+
+/* Next change after o's cursor. COOP_FEED_LOST means events were overwritten
+   before o read them: redraw from the cells, then keep reading. */
+CoopFeedStatus coop_feed_next(CoopSession *s, CoopObserver *o, CoopEvent *ev) {
+    if (!s || !o || !ev) return COOP_FEED_EMPTY;
+    uint64_t c = o->cursor;
+    FeedSlot *slot = &s->feed[c & (COOP_FEED_SIZE - 1)];
+    uint64_t want = 2 * c + 2;
+    uint64_t s1 = atomic_load(&slot->seq);
+    if (s1 < want) return COOP_FEED_EMPTY;   /* not published yet */
+    if (s1 == want) {
+        uint64_t d = atomic_load(&slot->data);
+        uint64_t where = atomic_load(&slot->cell);
+        if (atomic_load(&slot->seq) == want && (d >> 56) == feed_lap(c) && (where >> 56) == feed_lap(c)) {
+            int cell = (int)(where & 0xFFFFFFFFu);
+            ev->row = cell / GRID_SIZE;
+            ev->col = cell % GRID_SIZE;
+            ev->letter = (char)(d & 0xFF);
+            ev->player = (int)((d >> 8) & 0xFF);
+            ev->version = (unsigned)((d >> 16) & 0xFFFFFF);
+            o->cursor = c + 1;
+            return COOP_FEED_EVENT;
+        }
+    }
+    /* overwritten: skip to the oldest event that can still be in the ring */
+    uint64_t head = atomic_load(&s->feed_head);
+    uint64_t oldest = head > COOP_FEED_SIZE ? head - COOP_FEED_SIZE : 0;
+    o->cursor = oldest > c ? oldest : c + 1;
+    return COOP_FEED_LOST;
+}
+
+/* ----------------- Session ----------------- */
+
+/* The puzzle must outlive the session, and its layout must not change while
+   the session exists (stop any refiner first). */
+CoopSession *coop_create(Puzzle *p) {
+    if (!p) return NULL;
+    CoopSession *s = (CoopSession *) calloc(1, sizeof(CoopSession));
+    if (!s) return NULL;
+    s->p = p;
+    s->word_count = p->word_count;
+    s->hinted = (atomic_bool *) calloc((size_t)(p->word_count > 0 ? p->word_count : 1), sizeof(atomic_bool));
+    if (!s->hinted) { free(s); return NULL; }
+    int i = 0;
+    for (const WordNode *cur = p->positions_head; cur; cur = cur->next, ++i)
+        atomic_init(&s->hinted[i], cur->data.hint_used);
+    for (int k = 0; k < COOP_CELLS; ++k)
+        atomic_init(&s->cells[k], cell_pack(0, p->user[k / GRID_SIZE][k % GRID_SIZE]));
+    for (int k = 0; k < COOP_ID_WORDS; ++k)
+        atomic_init(&s->ids[k], k == 0 ? 1u : 0u);   /* id 0 means "no player" */
+    atomic_init(&s->hints_used, 0);
+    atomic_init(&s->feed_head, 0);
+    for (int k = 0; k < COOP_FEED_SIZE; ++k) {
+        atomic_init(&s->feed[k].seq, 0);
+        atomic_init(&s->feed[k].data, 0);
+        atomic_init(&s->feed[k].cell, 0);
+    }
+    return s;
+}
+
+/* All players must have left */
+void coop_free(CoopSession *s) {
+    if (!s) return;
+    free(s->hinted);
+    free(s);
+}
+
+/* Copy the shared cells and hint flags into the Puzzle, for draw_grid,
+   puzzle_completion and friends. Call from the thread that owns the Puzzle. */
+void coop_sync_to_puzzle(CoopSession *s) {
+    if (!s) return;
+    Puzzle *p = s->p;
+    for (int k = 0; k < COOP_CELLS; ++k)
+        p->user[k / GRID_SIZE][k % GRID_SIZE] = cell_letter(atomic_load(&s->cells[k]));
+    int i = 0;
+    for (WordNode *cur = p->positions_head; cur && i < s->word_count; cur = cur->next, ++i)
+        if (atomic_load(&s->hinted[i])) cur->data.hint_used = true;
+    int hints = atomic_load(&s->hints_used);
+    if (p->telemetry) p->telemetry->hints_used += hints - s->hints_synced;
+    s->hints_synced = hints;
+}
+
+/* ----------------- Players ----------------- */
+
+/* Lowest free id, or 0 when the session is full */
+static int claim_id(CoopSession *s) {
+    for (int w = 0; w < COOP_ID_WORDS; ++w) {
+        uint64_t cur = atomic_load(&s->ids[w]);
+        for (;;) {
+            uint64_t free_bits = ~cur;
+            if (w == COOP_ID_WORDS - 1 && (COOP_MAX_PLAYERS + 1) % 64)
+                free_bits &= (1ULL << ((COOP_MAX_PLAYERS + 1) % 64)) - 1;
+            if (!free_bits) break;
+            int bit = __builtin_ctzll(free_bits);
+            if (atomic_compare_exchange_weak(&s->ids[w], &cur, cur | 1ULL << bit))
+                return w * 64 + bit;
+        }
+    }
+    return 0;
+}
+
+static void release_id(CoopSession *s, int id) {
+    atomic_fetch_and(&s->ids[id / 64], ~(1ULL << (id % 64)));
+}
+
+/* NULL when COOP_MAX_PLAYERS players are already in the session */
+CoopPlayer *coop_join(CoopSession *s) {
+    if (!s) return NULL;
+    int id = claim_id(s);
+    if (!id) return NULL;
+    CoopPlayer *pl = (CoopPlayer *) calloc(1, sizeof(CoopPlayer));
+    if (!pl) { release_id(s, id); return NULL; }
+    pl->s = s;
+    pl->id = id;
+    pl->rng = (unsigned long long)monotonic_ns() ^ ((unsigned long long)id << 32) ^ (unsigned long long)(size_t)pl;
+    if (pl->rng == 0) pl->rng = 0x9E3779B97F4A7C15ULL;
+    return pl;
+}
+
+/* The id may be handed to the next player who joins; feed events already
+   published still carry it */
+void coop_leave(CoopPlayer *pl) {
+    if (!pl) return;
+    release_id(pl->s, pl->id);
+    free(pl->moves);
+    free(pl);
+}
+
+int coop_player_id(const CoopPlayer *pl) {
+    return pl ? pl->id : 0;
+}
+
+static bool remember(CoopPlayer *pl, int cell, uint32_t was, uint32_t wrote) {
+    if (pl->move_count == pl->move_cap) {
+        int cap = pl->move_cap ? pl->move_cap * 2 : 64;
+        CoopMove *grown = (CoopMove *) realloc(pl->moves, (size_t)cap * sizeof(CoopMove));
+        if (!grown) return false;
+        pl->moves = grown;
+        pl->move_cap = cap;
+    }
+    CoopMove mv = { cell, was, wrote };
+    pl->moves[pl->move_count++] = mv;
+    return true;
+}
+
+/* Write ch into a cell unless it already holds it */
+static void write_cell(CoopPlayer *pl, int cell, char ch) {
+    CoopSession *s = pl->s;
+    uint32_t cur = atomic_load(&s->cells[cell]);
+    uint32_t next;
+    do {
+        if (cell_letter(cur) == ch) return;
+        next = cell_pack(cell_version(cur) + 1, ch);
+    } while (!atomic_compare_exchange_weak(&s->cells[cell], &cur, next));
+    /* without history the move just can't be undone */
+    (void)remember(pl, cell, cur, next);
+    feed_publish(s, cell, ch, pl->id, cell_version(next));
+}
+
+static const WordPos *find_slot(const CoopSession *s, int clue, char d, int *index) {
+    int i = 0;
+    for (const WordNode *cur = s->p->positions_head; cur; cur = cur->next, ++i)
+        if (cur->data.clue_num == clue && cur->data.direction == d) {
+            if (index) *index = i;
+            return &cur->data;
+        }
+    return NULL;
+}
+
+bool coop_input_answer(CoopPlayer *pl, int clue, char d, const char *ans) {
+    if (!pl || !ans) return false;
+    const WordPos *wp = find_slot(pl->s, clue, d, NULL);
+    if (!wp) return false;
+    int L = (int)strlen(wp->word);
+    if ((int)strlen(ans) != L) return false;
+    for (int k = 0; k < L; ++k) {
+        int r = wp->row + (d == 'D' ? k : 0), c = wp->col + (d == 'A' ? k : 0);
+        write_cell(pl, r * GRID_SIZE + c, ans[k]);
+    }
+    return true;
+}
+
+/* Reveal one wrong letter of the clue; true also when nothing was left to reveal */
+bool coop_give_hint(CoopPlayer *pl, int clue, char d) {
+    if (!pl) return false;
+    CoopSession *s = pl->s;
+    int idx = 0;
+    const WordPos *wp = find_slot(s, clue, d, &idx);
+    if (!wp) return false;
+    int L = (int)strlen(wp->word);
+    for (;;) {
+        int choices[MAX_WORD_LENGTH], ccnt = 0;
+        uint32_t seen[MAX_WORD_LENGTH];
+        for (int k = 0; k < L; ++k) {
+            int r = wp->row + (d == 'D' ? k : 0), c = wp->col + (d == 'A' ? k : 0);
+            seen[k] = atomic_load(&s->cells[r * GRID_SIZE + c]);
+            if (cell_letter(seen[k]) != s->p->sol[r][c]) choices[ccnt++] = k;
+        }
+        if (ccnt == 0) return true;
+        int pick = choices[(rng_next(&pl->rng) >> 33) % (unsigned long long)ccnt];
+        int r = wp->row + (d == 'D' ? pick : 0), c = wp->col + (d == 'A' ? pick : 0);
+        int cell = r * GRID_SIZE + c;
+        uint32_t cur = seen[pick];
+        uint32_t next = cell_pack(cell_version(cur) + 1, s->p->sol[r][c]);
+        /* someone wrote this cell meanwhile: look again */
+        if (!atomic_compare_exchange_strong(&s->cells[cell], &cur, next)) continue;
+        (void)remember(pl, cell, cur, next);
+        feed_publish(s, cell, s->p->sol[r][c], pl->id, cell_version(next));
+        atomic_store(&s->hinted[idx], true);
+        atomic_fetch_add(&s->hints_used, 1);
+        return true;
+    }
+}
+
+/* Undo this player's last move. False if there is none, or if another
+   player has written that cell since (the move is dropped either way). */
+bool coop_undo(CoopPlayer *pl) {
+    if (!pl || pl->move_count == 0) return false;
+    CoopSession *s = pl->s;
+    CoopMove mv = pl->moves[--pl->move_count];
+    uint32_t expect = mv.wrote;
+    uint32_t next = cell_pack(cell_version(mv.wrote) + 1, cell_letter(mv.was));
+    if (!atomic_compare_exchange_strong(&s->cells[mv.cell], &expect, next)) return false;
+    /* the cell now holds next, not the value this player's earlier move on it
+       left; if nobody else wrote in between, that move stays undoable */
+    for (int i = pl->move_count - 1; i >= 0; --i) {
+        if (pl->moves[i].cell != mv.cell) continue;
+        if (pl->moves[i].wrote == mv.was) pl->moves[i].wrote = next;
+        break;
+    }
+    feed_publish(s, mv.cell, cell_letter(mv.was), pl->id, cell_version(next));
+    return true;
+}
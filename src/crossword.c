@@ -9,6 +9,11 @@
 #include <string.h>
 #include <ctype.h>
 #include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 
 /* ----------------- Platform helper ----------------- */
 
@@ -20,6 +25,42 @@ void clear_screen(void) {
 #endif
 }
 
+/* Monotonic clock in nanoseconds (for deadlines and interval timing) */
+long long monotonic_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (long long)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+/* xorshift64* step; each thread keeps its own state (rand() is not
+   thread-safe). The state must be non-zero. */
+unsigned long long rng_next(unsigned long long *s) {
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 2685821657736338717ULL;
+}
+
+/* Processors currently online (worker count for parallel generation) */
+int online_cpus(void) {
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors > 0 ? (int)si.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
 /* ----------------- Utilities ----------------- */
 
 void safe_gets(char *buf, int size) {
@@ -42,7 +83,10 @@ void to_upper_inplace(char *s) {
 
 void push_move(MoveStack *s, Move mv) {
     if (!s) return;
-    MoveStackNode *n = (MoveStackNode *) malloc(sizeof(MoveStackNode));
+    MoveStackNode *n = s->free_list;
+    if (n) s->free_list = n->next;
+    else if (s->arena) n = (MoveStackNode *) arena_alloc(s->arena, sizeof(MoveStackNode));
+    else n = (MoveStackNode *) malloc(sizeof(MoveStackNode));
     if (!n) return;
     n->mv = mv;
     n->next = s->top;
@@ -55,14 +99,18 @@ bool pop_move(MoveStack *s, Move *out) {
     MoveStackNode *n = s->top;
     if (out) *out = n->mv;
     s->top = n->next;
-    free(n);
+    if (s->arena) {
+        n->next = s->free_list;
+        s->free_list = n;
+    } else {
+        free(n);
+    }
     s->size--;
     return true;
 }
 
 /* Undo last user move: restore previous char in user grid */
-void undo_last_move(Puzzle *p) {
-    if (!p) return;
+static void undo_last_move_impl(Puzzle *p) {
     Move mv;
     if (!pop_move(&p->undo_stack, &mv)) {
         printf("%sNo moves to undo.%s\n", YELLOW, RESET);
@@ -74,10 +122,17 @@ void undo_last_move(Puzzle *p) {
     }
 }
 
+void undo_last_move(Puzzle *p) {
+    if (!p) return;
+    long long t0 = monotonic_ns();
+    undo_last_move_impl(p);
+    telemetry_record(p->telemetry, TELE_UNDO, monotonic_ns() - t0);
+}
+
 /* ----------------- BST Dictionary ----------------- */
 
-BSTNode *bst_new_node(const char *word) {
-    BSTNode *n = (BSTNode *) malloc(sizeof(BSTNode));
+BSTNode *bst_new_node(Arena *a, const char *word) {
+    BSTNode *n = (BSTNode *) arena_alloc(a, sizeof(BSTNode));
     if (!n) return NULL;
     n->left = n->right = NULL;
     strncpy(n->word, word, MAX_WORD_LENGTH-1);
@@ -86,28 +141,31 @@ BSTNode *bst_new_node(const char *word) {
 }
 
 /* BST insert (no duplicates - case sensitive expected uppercase) */
-BSTNode *bst_insert(BSTNode *root, const char *word) {
+BSTNode *bst_insert(Arena *a, BSTNode *root, const char *word) {
     if (!word || !word[0]) return root;
-    if (!root) return bst_new_node(word);
+    if (!root) return bst_new_node(a, word);
     int cmp = strcmp(word, root->word);
-    if (cmp < 0) root->left = bst_insert(root->left, word);
-    else if (cmp > 0) root->right = bst_insert(root->right, word);
+    if (cmp < 0) root->left = bst_insert(a, root->left, word);
+    else if (cmp > 0) root->right = bst_insert(a, root->right, word);
     /* equal -> skip */
     return root;
 }
 
-void bst_free(BSTNode *root) {
-    if (!root) return;
-    bst_free(root->left);
-    bst_free(root->right);
-    free(root);
-}
-
 int bst_count(BSTNode *root) {
     if (!root) return 0;
     return 1 + bst_count(root->left) + bst_count(root->right);
 }
 
+bool bst_contains(const BSTNode *root, const char *word) {
+    if (!word) return false;
+    while (root) {
+        int cmp = strcmp(word, root->word);
+        if (cmp == 0) return true;
+        root = (cmp < 0) ? root->left : root->right;
+    }
+    return false;
+}
+
 /* Collect words in-order (lexicographically ascending) into out[] */
 void bst_inorder_collect(BSTNode *root, char **out, int *idx, int max) {
     if (!root || !out || !idx || *idx >= max) return;
@@ -119,50 +177,49 @@ void bst_inorder_collect(BSTNode *root, char **out, int *idx, int max) {
     bst_inorder_collect(root->right, out, idx, max);
 }
 
-/* Populate default dictionary into BST */
-void populate_default_dictionary(Puzzle *p) {
-    if (!p) return;
-    /* default list uppercase */
-    const char *defs[] = {
-        "QUEUE", "STACK", "GRAPH", "ALGORITHM", "SEARCH", "SORT",
-        "TREE", "NODE", "ARRAY", "DATA", "PAINT", "ROBOT",
-        "NOISE", "OFFER", "ASSET", "COURT", "STEEP", "PYTHON"
-    };
-    int n = (int)(sizeof(defs)/sizeof(defs[0]));
-    for (int i = 0; i < n; ++i) p->dict_root = bst_insert(p->dict_root, defs[i]);
-}
-
 /* ----------------- Puzzle lifecycle ----------------- */
 
-Puzzle *puzzle_create(void) {
+Puzzle *puzzle_create(DictSnapshot *dict) {
     Puzzle *p = (Puzzle *) calloc(1, sizeof(Puzzle));
     if (!p) return NULL;
+    arena_init(&p->arena);
     p->positions_head = NULL;
+    p->positions_tail = NULL;
     p->word_count = 0;
     p->clue_counter = 1;
-    p->start_time = time(NULL);
+    p->start_ns = monotonic_ns();
     p->undo_stack.top = NULL;
     p->undo_stack.size = 0;
-    p->dict_root = NULL;
-    /* populate dictionary */
-    populate_default_dictionary(p);
+    p->undo_stack.free_list = NULL;
+    p->undo_stack.arena = &p->arena;
+    /* share the caller's dictionary, or build a private default one */
+    if (dict) dict_snapshot_retain(dict);
+    else dict = dict_snapshot_default();
+    p->dict = dict;
+    p->telemetry = telemetry_create();
+    if (!p->dict || !p->telemetry) {
+        dict_snapshot_release(p->dict);
+        telemetry_free(p->telemetry);
+        free(p);
+        return NULL;
+    }
     return p;
 }
 
+/* Switch to another snapshot (e.g. after a reload) for the next generation */
+void puzzle_set_dictionary(Puzzle *p, DictSnapshot *dict) {
+    if (!p || !dict || dict == p->dict) return;
+    dict_snapshot_retain(dict);
+    dict_snapshot_release(p->dict);
+    p->dict = dict;
+}
+
 void puzzle_free(Puzzle *p) {
     if (!p) return;
-    /* free linked list */
-    WordNode *cur = p->positions_head;
-    while (cur) {
-        WordNode *nx = cur->next;
-        free(cur);
-        cur = nx;
-    }
-    /* free BST */
-    bst_free(p->dict_root);
-    /* free undo stack */
-    Move mv;
-    while (pop_move(&p->undo_stack, &mv)) { /* pop until empty */ }
+    /* word list and undo stack live in the arena; the dictionary is shared */
+    arena_free(&p->arena);
+    dict_snapshot_release(p->dict);
+    telemetry_free(p->telemetry);
     free(p);
 }
 
@@ -174,16 +231,18 @@ bool puzzle_init(Puzzle *p) {
             p->user[r][c] = ' ';
             p->owner[r][c] = 0;
         }
-    /* free linked list */
-    WordNode *cur = p->positions_head;
-    while (cur) { WordNode *nx = cur->next; free(cur); cur = nx; }
+    /* drop word list and undo stack in one go; arena blocks are kept for reuse */
+    arena_reset(&p->arena);
     p->positions_head = NULL;
+    p->positions_tail = NULL;
     p->word_count = 0;
     p->clue_counter = 1;
-    p->start_time = time(NULL);
-    /* clear undo stack */
-    Move mv;
-    while (pop_move(&p->undo_stack, &mv)) {}
+    p->start_ns = monotonic_ns();
+    p->hash = 0;
+    p->undo_stack.top = NULL;
+    p->undo_stack.size = 0;
+    p->undo_stack.free_list = NULL;
+    p->played = false;
     return true;
 }
 
@@ -196,8 +255,8 @@ void puzzle_create_user_grid(Puzzle *p) {
 
 /* ----------------- Placement logic ----------------- */
 
-/* comparator for earlier qsort usage retained for small arrays (not used now) */
-static int cmp_len_desc(const void *a, const void *b) {
+/* qsort comparator: longest words first (shared with the tiled generator) */
+int cmp_len_desc(const void *a, const void *b) {
     const char * const *pa = (const char * const *)a;
     const char * const *pb = (const char * const *)b;
     size_t la = strlen(*pa), lb = strlen(*pb);
@@ -243,47 +302,101 @@ bool puzzle_can_place(Puzzle *p, const char *w, int r, int c, char d) {
     return true;
 }
 
-/* Append WordPos via linked list node and place letters */
-bool puzzle_place_word_record(Puzzle *p, const char *w, int r, int c, char d) {
-    if (!p || !w) return false;
-    if (!puzzle_can_place(p, w, r, c, d)) return false;
+/* Zobrist key for letter ch at (r,c). Derived with splitmix64 rather than a
+   random table so there is no global state to initialise. */
+uint64_t zobrist_key(int r, int c, char ch) {
+    uint64_t z = ((uint64_t)(r * GRID_SIZE + c) << 8 | (unsigned char)ch) + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
 
-    /* place letters */
+/* Write letters and ownership bits for a word without validation.
+   Returns the Zobrist delta for the newly filled cells; the caller folds it
+   into p->hash (tile workers accumulate it privately and merge later). */
+uint64_t puzzle_stamp_word(Puzzle *p, const char *w, int r, int c, char d) {
+    if (!p || !w) return 0;
     int L = (int)strlen(w);
-    if (d == 'A') {
-        for (int i = 0; i < L; ++i) {
-            p->sol[r][c+i] = w[i];
-            p->owner[r][c+i] |= OWNER_ACROSS;
-        }
-    } else {
-        for (int i = 0; i < L; ++i) {
-            p->sol[r+i][c] = w[i];
-            p->owner[r+i][c] |= OWNER_DOWN;
-        }
+    uint64_t delta = 0;
+    for (int i = 0; i < L; ++i) {
+        int rr = r + (d == 'D' ? i : 0), cc = c + (d == 'A' ? i : 0);
+        if (p->sol[rr][cc] == ' ') delta ^= zobrist_key(rr, cc, w[i]);
+        p->sol[rr][cc] = w[i];
+        p->owner[rr][cc] |= (d == 'A') ? OWNER_ACROSS : OWNER_DOWN;
     }
+    return delta;
+}
 
-    /* create linked list node */
-    WordNode *n = (WordNode *) malloc(sizeof(WordNode));
+/* Append a WordPos node for a word whose letters are already on the grid */
+bool puzzle_append_record(Puzzle *p, const char *w, int r, int c, char d) {
+    if (!p || !w) return false;
+    WordNode *n = (WordNode *) arena_alloc(&p->arena, sizeof(WordNode));
     if (!n) return false;
     strncpy(n->data.word, w, MAX_WORD_LENGTH-1);
     n->data.word[MAX_WORD_LENGTH-1] = '\0';
     n->data.row = r; n->data.col = c; n->data.direction = d;
     n->data.clue_num = p->clue_counter++;
     n->data.hint_used = false;
+    n->data.solved_ns = 0;
     n->next = NULL;
 
     /* append to tail for stable ordering */
-    if (!p->positions_head) {
-        p->positions_head = n;
-    } else {
-        WordNode *cur = p->positions_head;
-        while (cur->next) cur = cur->next;
-        cur->next = n;
-    }
+    if (!p->positions_head) p->positions_head = n;
+    else p->positions_tail->next = n;
+    p->positions_tail = n;
     p->word_count++;
     return true;
 }
 
+/* Append WordPos via linked list node and place letters */
+bool puzzle_place_word_record(Puzzle *p, const char *w, int r, int c, char d) {
+    if (!p || !w) return false;
+    if (!puzzle_can_place(p, w, r, c, d)) return false;
+    p->hash ^= puzzle_stamp_word(p, w, r, c, d);
+    return puzzle_append_record(p, w, r, c, d);
+}
+
+/* Remove a placed word: cells it shares with a crossing word keep their letter.
+   Clue numbers of the remaining words are unchanged.
+   If two of the kept cells are next to each other, the two crossing words
+   now touch side by side where this word joined them: the layout breaks the
+   placement rules (puzzle_can_place would never build it, and replaying the
+   word list fails) until a word is placed over those cells again. That case
+   returns UNPLACE_TOUCHING; the word is removed either way. */
+UnplaceResult puzzle_unplace_word(Puzzle *p, int clue, char d) {
+    if (!p) return UNPLACE_NOT_FOUND;
+    WordNode *prev = NULL, *cur = p->positions_head;
+    while (cur && !(cur->data.clue_num == clue && cur->data.direction == d)) {
+        prev = cur;
+        cur = cur->next;
+    }
+    if (!cur) return UNPLACE_NOT_FOUND;
+
+    const WordPos *wp = &cur->data;
+    int L = (int)strlen(wp->word);
+    unsigned char bit = (d == 'A') ? OWNER_ACROSS : OWNER_DOWN;
+    bool touching = false, kept_prev = false;
+    for (int i = 0; i < L; ++i) {
+        int rr = wp->row + (d == 'D' ? i : 0), cc = wp->col + (d == 'A' ? i : 0);
+        p->owner[rr][cc] &= (unsigned char)~bit;
+        bool kept = p->owner[rr][cc] != 0;
+        if (!kept) {
+            p->hash ^= zobrist_key(rr, cc, p->sol[rr][cc]);
+            p->sol[rr][cc] = ' ';
+            p->user[rr][cc] = ' ';
+        }
+        if (kept && kept_prev) touching = true;
+        kept_prev = kept;
+    }
+
+    /* unlink (node memory stays in the arena until the next reset) */
+    if (prev) prev->next = cur->next;
+    else p->positions_head = cur->next;
+    if (p->positions_tail == cur) p->positions_tail = prev;
+    p->word_count--;
+    return touching ? UNPLACE_TOUCHING : UNPLACE_OK;
+}
+
 /* Find an intersection using linked list iteration */
 int puzzle_find_intersection(Puzzle *p, const char *w, int *out_r, int *out_c, char *out_d) {
     if (!p || !w) return 0;
@@ -319,24 +432,33 @@ int puzzle_find_intersection(Puzzle *p, const char *w, int *out_r, int *out_c, c
     return 0;
 }
 
+/* Place a word crossing an existing one if possible, else at the first free slot */
+bool puzzle_place_anywhere(Puzzle *p, const char *w) {
+    if (!p || !w) return false;
+    int r, c; char d;
+    if (puzzle_find_intersection(p, w, &r, &c, &d))
+        return puzzle_place_word_record(p, w, r, c, d);
+    for (int rr = 0; rr < GRID_SIZE; ++rr) {
+        for (int cc = 0; cc < GRID_SIZE; ++cc) {
+            if (puzzle_place_word_record(p, w, rr, cc, 'A')) return true;
+            if (puzzle_place_word_record(p, w, rr, cc, 'D')) return true;
+        }
+    }
+    return false;
+}
+
 /* ----------------- Puzzle generation using BST as source ----------------- */
 
-/* Create temporary list of words from BST, sort by length descending implicitly by qsort
-   (we collect lexicographic order from BST and then qsort by length). */
+/* Generate from the dictionary snapshot; its words are already longest first */
 bool puzzle_generate_from_bst(Puzzle *p) {
-    if (!p) return false;
-    int n = bst_count(p->dict_root);
-    if (n <= 0) return false;
-    /* collect words */
-    char **arr = (char **) malloc(sizeof(char *) * n);
-    if (!arr) return false;
-    int idx = 0;
-    bst_inorder_collect(p->dict_root, arr, &idx, n);
-    /* We have lexicographic list in arr; now sort by length descending */
-    qsort(arr, (size_t)n, sizeof(char *), cmp_len_desc);
-    bool ok = puzzle_generate(p, arr, n);
-    free(arr);
-    return ok;
+    if (!p || !p->dict || p->dict->count <= 0) return false;
+    char **arr = p->dict->by_length;
+    int n = p->dict->count;
+    /* large (poster) builds split the grid into tiles generated in parallel;
+       below two whole tiles per side the serial generator does better */
+    return (GRID_SIZE >= 2 * TILE_SIZE_DEFAULT)
+         ? puzzle_generate_tiled(p, arr, n, TILE_SIZE_DEFAULT, 0)
+         : puzzle_generate(p, arr, n);
 }
 
 /* Original generator takes word pointers array — we reuse it */
@@ -371,24 +493,10 @@ bool puzzle_generate(Puzzle *p, char **words, int count) {
     }
 
     /* place remaining words: try intersection first */
-    for (int i = 1; i < wc; ++i) {
-        int r, c; char d;
-        if (puzzle_find_intersection(p, tmp[i], &r, &c, &d)) {
-            (void)puzzle_place_word_record(p, tmp[i], r, c, d);
-            continue;
-        }
-        bool placed = false;
-        for (int rr = 0; rr < GRID_SIZE && !placed; ++rr) {
-            for (int cc = 0; cc < GRID_SIZE && !placed; ++cc) {
-                if (puzzle_place_word_record(p, tmp[i], rr, cc, 'A')) placed = true;
-                else if (puzzle_place_word_record(p, tmp[i], rr, cc, 'D')) placed = true;
-            }
-        }
-        (void)placed;
-    }
+    for (int i = 1; i < wc; ++i) (void)puzzle_place_anywhere(p, tmp[i]);
 
     puzzle_create_user_grid(p);
-    p->start_time = time(NULL);
+    p->start_ns = monotonic_ns();
     free(tmp);
     return p->word_count > 0;
 }
@@ -415,18 +523,13 @@ static void print_centered_str(const char *s, int width) {
 
 /* ----------------- Drawing (ASCII Option A) ----------------- */
 
-void draw_grid(const Puzzle *p, bool solution_view) {
-    if (!p) return;
-
+static void draw_grid_impl(const Puzzle *p, bool solution_view) {
     const int ROW_LABEL_WIDTH = 4;  /* space reserved for row numbers */
     const int CELL_WIDTH = 5;       /* internal width of each cell */
 
     const char *border_col = BOLD;
     const char *blank_col  = CYAN;
 
-    /* refresh screen */
-    clear_screen();
-
     /* column header: align with ROW_LABEL_WIDTH */
     for (int i = 0; i < ROW_LABEL_WIDTH; ++i) putchar(' ');
     for (int c = 0; c < GRID_SIZE; ++c) {
@@ -512,6 +615,15 @@ void draw_grid(const Puzzle *p, bool solution_view) {
     putchar('\n');
 }
 
+void draw_grid(const Puzzle *p, bool solution_view) {
+    if (!p) return;
+    /* refresh screen; not timed, since it spawns a shell */
+    clear_screen();
+    long long t0 = monotonic_ns();
+    draw_grid_impl(p, solution_view);
+    telemetry_record(p->telemetry, TELE_DRAW_GRID, monotonic_ns() - t0);
+}
+
 /* ----------------- Clues ----------------- */
 
 void show_clues(const Puzzle *p) {
@@ -550,8 +662,7 @@ void show_clues(const Puzzle *p) {
 
 /* ----------------- Interaction ----------------- */
 
-bool input_answer(Puzzle *p, int clue, char d, const char *ans) {
-    if (!p || !ans) return false;
+static bool input_answer_impl(Puzzle *p, int clue, char d, const char *ans) {
     WordNode *cur = p->positions_head;
     while (cur) {
         if (cur->data.clue_num == clue && cur->data.direction == d) {
@@ -576,6 +687,7 @@ bool input_answer(Puzzle *p, int clue, char d, const char *ans) {
                     p->user[rr][cc] = ans[k];
                 }
             }
+            p->played = true;
             printf("%sPlaced answer for clue %d %c.%s\n", GREEN, clue, d, RESET);
             return true;
         }
@@ -585,8 +697,7 @@ bool input_answer(Puzzle *p, int clue, char d, const char *ans) {
     return false;
 }
 
-bool give_hint(Puzzle *p, int clue, char d) {
-    if (!p) return false;
+static bool give_hint_impl(Puzzle *p, int clue, char d) {
     WordNode *cur = p->positions_head;
     while (cur) {
         if (cur->data.clue_num == clue && cur->data.direction == d) {
@@ -609,7 +720,9 @@ bool give_hint(Puzzle *p, int clue, char d) {
             Move mv = { rr, cc2, p->user[rr][cc2], p->sol[rr][cc2] };
             push_move(&p->undo_stack, mv);
             p->user[rr][cc2] = p->sol[rr][cc2];
+            p->played = true;
             wp->hint_used = true;
+            if (p->telemetry) p->telemetry->hints_used++;
             printf("%sHint: revealed letter %d -> %c%s\n", CYAN, pick + 1, p->sol[rr][cc2], RESET);
             return true;
         }
@@ -619,27 +732,41 @@ bool give_hint(Puzzle *p, int clue, char d) {
     return false;
 }
 
+/* Timed entry points: latency goes to telemetry, then newly solved words are noted */
+bool input_answer(Puzzle *p, int clue, char d, const char *ans) {
+    if (!p || !ans) return false;
+    long long t0 = monotonic_ns();
+    bool ok = input_answer_impl(p, clue, d, ans);
+    telemetry_record(p->telemetry, TELE_INPUT_ANSWER, monotonic_ns() - t0);
+    if (ok) telemetry_note_progress(p);
+    return ok;
+}
+
+bool give_hint(Puzzle *p, int clue, char d) {
+    if (!p) return false;
+    long long t0 = monotonic_ns();
+    bool ok = give_hint_impl(p, clue, d);
+    telemetry_record(p->telemetry, TELE_GIVE_HINT, monotonic_ns() - t0);
+    if (ok) telemetry_note_progress(p);
+    return ok;
+}
+
 /* ----------------- Progress / Timer ----------------- */
 
+/* Solved when the grid matches the solution, or holds another valid fill of
+   the same clues (a player can't tell such fills apart from the clues alone) */
 bool puzzle_solved(const Puzzle *p) {
     if (!p) return false;
-    for (int r = 0; r < GRID_SIZE; ++r)
-        for (int c = 0; c < GRID_SIZE; ++c)
-            if (p->sol[r][c] != ' ')
-                if (p->user[r][c] != p->sol[r][c]) return false;
-    return true;
+    PuzzleScore s = {0};
+    puzzle_score_batch(&p, 1, &s);
+    return s.solved;
 }
 
 float puzzle_completion(const Puzzle *p) {
     if (!p) return 0.0f;
-    int total = 0, good = 0;
-    for (int r = 0; r < GRID_SIZE; ++r)
-        for (int c = 0; c < GRID_SIZE; ++c)
-            if (p->sol[r][c] != ' ') {
-                total++;
-                if (p->user[r][c] == p->sol[r][c]) good++;
-            }
-    return total ? (float)good * 100.0f / (float)total : 0.0f;
+    PuzzleScore s = {0};
+    puzzle_score_batch(&p, 1, &s);
+    return s.completion;
 }
 
 void show_timer(const Puzzle *p) {
@@ -647,8 +774,9 @@ void show_timer(const Puzzle *p) {
 
     clear_screen();
 
-    int sec = (int) difftime(time(NULL), p->start_time);
-    printf("%sElapsed time: %02d:%02d%s\n", CYAN, sec / 60, sec % 60, RESET);
+    long long ms = (monotonic_ns() - p->start_ns) / 1000000LL;
+    printf("%sElapsed time: %02lld:%02lld.%03lld%s\n", CYAN,
+           ms / 60000, (ms / 1000) % 60, ms % 1000, RESET);
 
     printf("\nPress ENTER to return to menu...");
     getchar();
@@ -0,0 +1,206 @@
+/* src/dict.c
+ *
+ * Immutable dictionary snapshots shared by every Puzzle and worker thread.
+ *
+ * A DictSnapshot is never modified after it is built, so any number of
+ * threads can read it without locks. Lifetime is reference counted.
+ *
+ * A DictStore holds the current snapshot. Readers take a reference without
+ * blocking; a new word list is published by swapping the pointer and then
+ * waiting for a grace period (RCU style) before dropping the store's
+ * reference to the old snapshot. Readers that still hold the old snapshot
+ * keep using it until they release it.
+ *
+ * Grace period: a reader bumps one of two "active" counters, chosen by the
+ * epoch parity, around its pointer load + retain. After swapping, the
+ * publisher flips the epoch twice, each time waiting for the counter that no
+ * longer receives new readers to drain. Any reader that could have loaded
+ * the old pointer without yet holding a reference has then finished.
+ */
+
+#include "../include/crossword.h"
+#include <ctype.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct DictStore {
+    _Atomic(DictSnapshot *) current;
+    atomic_uint epoch;
+    atomic_int active[2];
+    pthread_mutex_t publish_lock;   /* serialises publishers only */
+    pthread_t loader;
+    bool loader_running;
+    char *loader_path;
+};
+
+/* ----------------- Snapshots ----------------- */
+
+/* Uppercase into buf; false if the word has non-letters or a bad length */
+static bool normalise_word(const char *w, char *buf) {
+    size_t L = strlen(w);
+    if (L < 2 || L >= MAX_WORD_LENGTH) return false;
+    for (size_t i = 0; i < L; ++i) {
+        if (!isalpha((unsigned char)w[i])) return false;
+        buf[i] = (char) toupper((unsigned char)w[i]);
+    }
+    buf[L] = '\0';
+    return true;
+}
+
+static void collect_by_length(DictSnapshot *d) {
+    int idx = 0;
+    bst_inorder_collect(d->root, d->by_length, &idx, d->count);
+    qsort(d->by_length, (size_t)d->count, sizeof(char *), cmp_len_desc);
+}
+
+DictSnapshot *dict_snapshot_build(const char *const *words, int n) {
+    if (!words || n <= 0) return NULL;
+    DictSnapshot *d = (DictSnapshot *) calloc(1, sizeof(DictSnapshot));
+    if (!d) return NULL;
+    arena_init(&d->arena);
+    char buf[MAX_WORD_LENGTH];
+    for (int i = 0; i < n; ++i)
+        if (words[i] && normalise_word(words[i], buf))
+            d->root = bst_insert(&d->arena, d->root, buf);
+    d->count = bst_count(d->root);
+    d->by_length = (d->count > 0) ? (char **) malloc(sizeof(char *) * d->count) : NULL;
+    if (d->count <= 0 || !d->by_length) {
+        arena_free(&d->arena);
+        free(d->by_length);
+        free(d);
+        return NULL;
+    }
+    collect_by_length(d);
+    atomic_init(&d->refs, 1);
+    return d;
+}
+
+DictSnapshot *dict_snapshot_default(void) {
+    /* default list uppercase */
+    static const char *const defs[] = {
+        "QUEUE", "STACK", "GRAPH", "ALGORITHM", "SEARCH", "SORT",
+        "TREE", "NODE", "ARRAY", "DATA", "PAINT", "ROBOT",
+        "NOISE", "OFFER", "ASSET", "COURT", "STEEP", "PYTHON"
+    };
+    return dict_snapshot_build(defs, (int)(sizeof(defs)/sizeof(defs[0])));
+}
+
+/* One word per line; blank lines and lines with non-letters are skipped */
+DictSnapshot *dict_snapshot_load_file(const char *path) {
+    if (!path) return NULL;
+    FILE *f = fopen(path, "r");
+    if (!f) return NULL;
+    int cap = 256, n = 0;
+    char **words = (char **) malloc(sizeof(char *) * cap);
+    char line[256];
+    while (words && fgets(line, sizeof(line), f)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        char *w = line;
+        while (*w == ' ' || *w == '\t') ++w;
+        size_t L = strlen(w);
+        while (L > 0 && (w[L-1] == ' ' || w[L-1] == '\t')) w[--L] = '\0';
+        if (L == 0) continue;
+        if (n == cap) {
+            cap *= 2;
+            char **grown = (char **) realloc(words, sizeof(char *) * cap);
+            if (!grown) break;
+            words = grown;
+        }
+        words[n] = (char *) malloc(L + 1);
+        if (!words[n]) break;
+        memcpy(words[n], w, L + 1);
+        n++;
+    }
+    fclose(f);
+    DictSnapshot *d = words ? dict_snapshot_build((const char *const *)words, n) : NULL;
+    for (int i = 0; i < n; ++i) free(words[i]);
+    free(words);
+    return d;
+}
+
+void dict_snapshot_retain(DictSnapshot *d) {
+    if (d) atomic_fetch_add(&d->refs, 1);
+}
+
+void dict_snapshot_release(DictSnapshot *d) {
+    if (!d) return;
+    if (atomic_fetch_sub(&d->refs, 1) != 1) return;
+    arena_free(&d->arena);
+    free(d->by_length);
+    free(d);
+}
+
+/* ----------------- Store (atomic publish, lock-free readers) ----------------- */
+
+DictStore *dict_store_create(DictSnapshot *initial) {
+    if (!initial) return NULL;
+    DictStore *s = (DictStore *) calloc(1, sizeof(DictStore));
+    if (!s) return NULL;
+    atomic_init(&s->current, initial);   /* takes over the caller's reference */
+    atomic_init(&s->epoch, 0);
+    atomic_init(&s->active[0], 0);
+    atomic_init(&s->active[1], 0);
+    if (pthread_mutex_init(&s->publish_lock, NULL) != 0) { free(s); return NULL; }
+    return s;
+}
+
+/* Never blocks; the caller owns the returned reference */
+DictSnapshot *dict_store_acquire(DictStore *s) {
+    if (!s) return NULL;
+    unsigned e = atomic_load(&s->epoch) & 1u;
+    atomic_fetch_add(&s->active[e], 1);
+    DictSnapshot *d = atomic_load(&s->current);
+    dict_snapshot_retain(d);
+    atomic_fetch_sub(&s->active[e], 1);
+    return d;
+}
+
+/* Takes over the caller's reference to snap. Blocks only this publisher. */
+void dict_store_publish(DictStore *s, DictSnapshot *snap) {
+    if (!s || !snap) return;
+    pthread_mutex_lock(&s->publish_lock);
+    DictSnapshot *old = atomic_exchange(&s->current, snap);
+    for (int flip = 0; flip < 2; ++flip) {
+        unsigned e = atomic_fetch_add(&s->epoch, 1) & 1u;
+        while (atomic_load(&s->active[e]) != 0) sched_yield();
+    }
+    pthread_mutex_unlock(&s->publish_lock);
+    dict_snapshot_release(old);
+}
+
+static void *loader_main(void *arg) {
+    DictStore *s = (DictStore *)arg;
+    DictSnapshot *d = dict_snapshot_load_file(s->loader_path);
+    if (d) dict_store_publish(s, d);
+    else fprintf(stderr, "Dictionary reload failed: %s\n", s->loader_path);
+    return NULL;
+}
+
+/* Load a word list on a background thread and publish it when ready */
+bool dict_store_reload_async(DictStore *s, const char *path) {
+    if (!s || !path) return false;
+    if (s->loader_running) {
+        pthread_join(s->loader, NULL);
+        s->loader_running = false;
+    }
+    free(s->loader_path);
+    s->loader_path = (char *) malloc(strlen(path) + 1);
+    if (!s->loader_path) return false;
+    strcpy(s->loader_path, path);
+    if (pthread_create(&s->loader, NULL, loader_main, s) != 0) return false;
+    s->loader_running = true;
+    return true;
+}
+
+void dict_store_free(DictStore *s) {
+    if (!s) return;
+    if (s->loader_running) pthread_join(s->loader, NULL);
+    free(s->loader_path);
+    dict_snapshot_release(atomic_load(&s->current));
+    pthread_mutex_destroy(&s->publish_lock);
+    free(s);
+}
@@ -0,0 +1,288 @@
+/* src/dlx.c
+ *
+ * Solution counting with dancing links (exact cover with colours).
+ *
+ * A player only sees each slot's length and its first and last letters, so
+ * the puzzle is ambiguous if the dictionary has another way to fill every
+ * slot. That is modelled as an exact cover problem:
+ *   - one primary item per slot (each slot gets exactly one word),
+ *   - one secondary item per dictionary word (a word is used at most once),
+ *   - one coloured secondary item per crossing cell (both words that cross
+ *     there must agree on the letter, which is the item's colour).
+ * Each option is "put word W in slot S". The search stops as soon as the
+ * requested number of solutions has been found.
+ */
+
+#include "../include/crossword.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    int *llink, *rlink;          /* item list, 0 = primary header, N+1 = secondary header */
+    int *top, *ulink, *dlink;    /* node arrays; top[] doubles as length for headers */
+    int *color;
+    int nodes;                   /* next free node */
+    long found;
+    long limit;
+} Dlx;
+
+static void dlx_hide(Dlx *x, int p) {
+    for (int q = p + 1; q != p; ) {
+        int t = x->top[q], u = x->ulink[q], d = x->dlink[q];
+        if (t <= 0) { q = u; continue; }
+        if (x->color[q] >= 0) {
+            x->dlink[u] = d; x->ulink[d] = u;
+            x->top[t]--;
+        }
+        q++;
+    }
+}
+
+static void dlx_unhide(Dlx *x, int p) {
+    for (int q = p - 1; q != p; ) {
+        int t = x->top[q], u = x->ulink[q], d = x->dlink[q];
+        if (t <= 0) { q = d; continue; }
+        if (x->color[q] >= 0) {
+            x->dlink[u] = q; x->ulink[d] = q;
+            x->top[t]++;
+        }
+        q--;
+    }
+}
+
+static void dlx_cover(Dlx *x, int i) {
+    for (int p = x->dlink[i]; p != i; p = x->dlink[p]) dlx_hide(x, p);
+    int l = x->llink[i], r = x->rlink[i];
+    x->rlink[l] = r; x->llink[r] = l;
+}
+
+static void dlx_uncover(Dlx *x, int i) {
+    int l = x->llink[i], r = x->rlink[i];
+    x->rlink[l] = i; x->llink[r] = i;
+    for (int p = x->ulink[i]; p != i; p = x->ulink[p]) dlx_unhide(x, p);
+}
+
+static void dlx_purify(Dlx *x, int p) {
+    int c = x->color[p], i = x->top[p];
+    for (int q = x->dlink[i]; q != i; q = x->dlink[q]) {
+        if (x->color[q] == c) x->color[q] = -1;
+        else dlx_hide(x, q);
+    }
+}
+
+static void dlx_unpurify(Dlx *x, int p) {
+    int c = x->color[p], i = x->top[p];
+    for (int q = x->ulink[i]; q != i; q = x->ulink[q]) {
+        if (x->color[q] < 0) x->color[q] = c;
+        else dlx_unhide(x, q);
+    }
+}
+
+/* Nodes already purified (colour -1) by an earlier commit are left alone.
+   The committing node itself keeps its colour: by the time it is committed
+   its option has been unlinked from every column, so purify never sees it. */
+static void dlx_commit(Dlx *x, int p) {
+    if (x->color[p] == 0) dlx_cover(x, x->top[p]);
+    else if (x->color[p] > 0) dlx_purify(x, p);
+}
+
+static void dlx_uncommit(Dlx *x, int p) {
+    if (x->color[p] == 0) dlx_uncover(x, x->top[p]);
+    else if (x->color[p] > 0) dlx_unpurify(x, p);
+}
+
+static void dlx_search(Dlx *x) {
+    if (x->rlink[0] == 0) { x->found++; return; }
+
+    /* minimum remaining values: branch on the slot with fewest candidates */
+    int best = -1, best_len = 0;
+    for (int i = x->rlink[0]; i != 0; i = x->rlink[i]) {
+        if (best < 0 || x->top[i] < best_len) { best = i; best_len = x->top[i]; }
+    }
+    if (best_len == 0) return;
+
+    dlx_cover(x, best);
+    for (int r = x->dlink[best]; r != best && x->found < x->limit; r = x->dlink[r]) {
+        for (int p = r + 1; p != r; ) {
+            if (x->top[p] <= 0) { p = x->ulink[p]; continue; }
+            dlx_commit(x, p);
+            p++;
+        }
+        dlx_search(x);
+        for (int p = r - 1; p != r; ) {
+            if (x->top[p] <= 0) { p = x->dlink[p]; continue; }
+            dlx_uncommit(x, p);
+            p--;
+        }
+    }
+    dlx_uncover(x, best);
+}
+
+static void dlx_free(Dlx *x) {
+    free(x->llink); free(x->rlink);
+    free(x->top); free(x->ulink); free(x->dlink); free(x->color);
+}
+
+/* Append a node for item i to the option being built */
+static void dlx_add_node(Dlx *x, int i, int color) {
+    int n = x->nodes++;
+    x->top[n] = i;
+    x->color[n] = color;
+    x->ulink[n] = x->ulink[i];
+    x->dlink[n] = i;
+    x->dlink[x->ulink[i]] = n;
+    x->ulink[i] = n;
+    x->top[i]++;
+}
+
+/* Close the current option with a spacer; `first` is its first node */
+static void dlx_add_spacer(Dlx *x, int first) {
+    int s = x->nodes++;
+    x->top[s] = x->top[first - 1] - 1;   /* spacers count down: 0, -1, -2, ... */
+    x->ulink[s] = first;
+    x->dlink[s] = 0;
+    x->color[s] = 0;
+    x->dlink[first - 1] = s - 1;         /* previous spacer points at last node */
+}
+
+/* Does dictionary word w match what the player is told about slot wp? */
+static bool slot_accepts(const WordPos *wp, int L, const char *w) {
+    return (int)strlen(w) == L && w[0] == wp->word[0] && w[L-1] == wp->word[L-1];
+}
+
+int puzzle_count_solutions(const Puzzle *p, char **words, int count, int limit) {
+    if (!p || !words || count <= 0 || limit <= 0 || p->word_count <= 0) return 0;
+
+    int slots = p->word_count;
+    const WordPos **slot = (const WordPos **) malloc((size_t)slots * sizeof(WordPos *));
+    int *cellcol = (int *) malloc((size_t)GRID_SIZE * GRID_SIZE * sizeof(int));
+    int *wordcol = (int *) malloc((size_t)count * sizeof(int));
+    if (!slot || !cellcol || !wordcol) {
+        free(slot); free(cellcol); free(wordcol);
+        return 0;
+    }
+    int k = 0;
+    for (const WordNode *cur = p->positions_head; cur && k < slots; cur = cur->next) slot[k++] = &cur->data;
+    slots = k;
+
+    /* items: slots first (primary), then used words and crossing cells (secondary) */
+    int items = slots;
+    int options = 0, option_nodes = 0;
+    for (int j = 0; j < count; ++j) wordcol[j] = 0;
+    for (int i = 0; i < GRID_SIZE * GRID_SIZE; ++i) cellcol[i] = 0;
+    for (int s = 0; s < slots; ++s) {
+        int L = (int)strlen(slot[s]->word);
+        int crossings = 0;
+        for (int t = 0; t < L; ++t) {
+            int r = slot[s]->row + (slot[s]->direction == 'D' ? t : 0);
+            int c = slot[s]->col + (slot[s]->direction == 'A' ? t : 0);
+            if (p->owner[r][c] == (OWNER_ACROSS | OWNER_DOWN)) {
+                crossings++;
+                if (cellcol[r * GRID_SIZE + c] == 0) cellcol[r * GRID_SIZE + c] = ++items;
+            }
+        }
+        for (int j = 0; j < count; ++j) {
+            if (!words[j] || !slot_accepts(slot[s], L, words[j])) continue;
+            if (wordcol[j] == 0) wordcol[j] = -1;   /* mark as used, numbered below */
+            options++;
+            option_nodes += 2 + crossings;
+        }
+    }
+    for (int j = 0; j < count; ++j) if (wordcol[j] < 0) wordcol[j] = ++items;
+
+    Dlx x = {0};
+    int total = items + 1 + option_nodes + options + 1;
+    x.llink = (int *) malloc((size_t)(items + 2) * sizeof(int));
+    x.rlink = (int *) malloc((size_t)(items + 2) * sizeof(int));
+    x.top = (int *) calloc((size_t)total, sizeof(int));
+    x.ulink = (int *) malloc((size_t)total * sizeof(int));
+    x.dlink = (int *) malloc((size_t)total * sizeof(int));
+    x.color = (int *) calloc((size_t)total, sizeof(int));
+    if (!x.llink || !x.rlink || !x.top || !x.ulink || !x.dlink || !x.color) {
+        dlx_free(&x);
+        free(slot); free(cellcol); free(wordcol);
+        return 0;
+    }
+
+    /* primaries 1..slots in the list headed by 0; secondaries in the list headed by items+1 */
+    for (int i = 0; i <= items + 1; ++i) { x.llink[i] = i - 1; x.rlink[i] = i + 1; }
+    x.llink[0] = slots; x.rlink[slots] = 0;
+    x.llink[slots + 1] = items + 1; x.rlink[items + 1] = slots + 1;
+    x.llink[items + 1] = items;
+    if (items == slots) { x.llink[items + 1] = x.rlink[items + 1] = items + 1; }
+    for (int i = 1; i <= items; ++i) { x.top[i] = 0; x.ulink[i] = x.dlink[i] = i; }
+
+    /* first spacer */
+    x.nodes = items + 1;
+    x.top[x.nodes] = 0;
+    x.ulink[x.nodes] = 0;
+    x.dlink[x.nodes] = 0;
+    x.nodes++;
+
+    for (int s = 0; s < slots; ++s) {
+        int L = (int)strlen(slot[s]->word);
+        for (int j = 0; j < count; ++j) {
+            if (!words[j] || !slot_accepts(slot[s], L, words[j])) continue;
+            int first = x.nodes;
+            dlx_add_node(&x, s + 1, 0);
+            dlx_add_node(&x, wordcol[j], 0);
+            for (int t = 0; t < L; ++t) {
+                int r = slot[s]->row + (slot[s]->direction == 'D' ? t : 0);
+                int c = slot[s]->col + (slot[s]->direction == 'A' ? t : 0);
+                int col = cellcol[r * GRID_SIZE + c];
+                if (col) dlx_add_node(&x, col, (unsigned char)words[j][t]);
+            }
+            dlx_add_spacer(&x, first);
+        }
+    }
+
+    x.found = 0;
+    x.limit = limit;
+    dlx_search(&x);
+
+    dlx_free(&x);
+    free(slot); free(cellcol); free(wordcol);
+    return (int)x.found;
+}
+
+/* Fills of p's slots from its dictionary, counted up to DLX_SOLUTION_LIMIT.
+   0 means no fill was found at all, e.g. an answer missing from the
+   dictionary (puzzle_generate on a caller's word list), not ambiguity. */
+int puzzle_solution_count(Puzzle *p) {
+    if (!p || !p->dict) return 0;
+    return puzzle_count_solutions(p, p->dict->by_length, p->dict->count, DLX_SOLUTION_LIMIT);
+}
+
+bool puzzle_has_unique_solution(Puzzle *p) {
+    return puzzle_solution_count(p) == 1;
+}
+
+/* Accept any fill where every slot holds a distinct dictionary word that
+   matches the clue; crossings agree automatically since the grid is shared. */
+bool puzzle_fill_valid(const Puzzle *p) {
+    if (!p || !p->positions_head || !p->dict) return false;
+    char buf[MAX_WORD_LENGTH];
+    for (const WordNode *cur = p->positions_head; cur; cur = cur->next) {
+        const WordPos *wp = &cur->data;
+        int L = (int)strlen(wp->word);
+        for (int t = 0; t < L; ++t) {
+            int r = wp->row + (wp->direction == 'D' ? t : 0);
+            int c = wp->col + (wp->direction == 'A' ? t : 0);
+            buf[t] = p->user[r][c];
+        }
+        buf[L] = '\0';
+        if (!slot_accepts(wp, L, buf) || !bst_contains(p->dict->root, buf)) return false;
+        for (const WordNode *prev = p->positions_head; prev != cur; prev = prev->next) {
+            const WordPos *pp = &prev->data;
+            if ((int)strlen(pp->word) != L) continue;
+            bool same = true;
+            for (int t = 0; t < L && same; ++t) {
+                int r = pp->row + (pp->direction == 'D' ? t : 0);
+                int c = pp->col + (pp->direction == 'A' ? t : 0);
+                same = p->user[r][c] == buf[t];
+            }
+            if (same) return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,486 @@
+/* src/refine.c
+ *
+ * Anytime generation: the greedy layout is shown straight away while a
+ * background thread keeps trying randomised layouts until a deadline.
+ *
+ * The refiner never touches the live Puzzle. Each improvement is built in a
+ * private Puzzle and published through an atomic pointer; the game thread
+ * picks it up with puzzle_refine_poll between menu actions and adopts it only
+ * if the player has not made a move yet.
+ *
+ * The second part of the budget goes to repair (large neighbourhood search):
+ * instead of starting from an empty grid, a few neighbouring words of the
+ * best layout are lifted off and the hole is refilled from the dictionary,
+ * keeping the result only if the layout score improves. puzzle_repair runs
+ * the same search synchronously on a puzzle that has not been started.
+ */
+
+#include "../include/crossword.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct Refiner {
+    pthread_t thread;
+    bool running;
+    atomic_bool stop;
+    _Atomic(Puzzle *) best;      /* latest improvement not yet adopted */
+    DictSnapshot *dict;          /* own reference; words come from here */
+    long long deadline_ns;
+    int best_score;
+    unsigned long long rng;
+    TransTable *tt;              /* states already explored by earlier restarts */
+    long long repair_from_ns;    /* switch from restarts to repair at this time */
+    Puzzle *base;                /* private copy of the best layout, for repair */
+};
+
+/* ----------------- Layout scoring ----------------- */
+
+/* More words and more crossings are better; a larger bounding box is worse */
+int puzzle_layout_score(const Puzzle *p) {
+    if (!p) return 0;
+    int crossings = 0;
+    int rmin = GRID_SIZE, rmax = -1, cmin = GRID_SIZE, cmax = -1;
+    for (int r = 0; r < GRID_SIZE; ++r)
+        for (int c = 0; c < GRID_SIZE; ++c) {
+            if (p->sol[r][c] == ' ') continue;
+            if (p->owner[r][c] == (OWNER_ACROSS | OWNER_DOWN)) crossings++;
+            if (r < rmin) rmin = r;
+            if (r > rmax) rmax = r;
+            if (c < cmin) cmin = c;
+            if (c > cmax) cmax = c;
+        }
+    int area = (rmax < 0) ? 0 : (rmax - rmin + 1) * (cmax - cmin + 1);
+    return p->word_count * LAYOUT_WORD_WEIGHT + crossings * LAYOUT_CROSS_WEIGHT - area;
+}
+
+/* Rebuild dst with src's words in src's order (clue numbers come out the same) */
+bool puzzle_copy_layout(Puzzle *dst, const Puzzle *src) {
+    if (!dst || !src) return false;
+    if (!puzzle_init(dst)) return false;
+    for (const WordNode *cur = src->positions_head; cur; cur = cur->next) {
+        const WordPos *wp = &cur->data;
+        if (!puzzle_place_word_record(dst, wp->word, wp->row, wp->col, wp->direction)) return false;
+    }
+    puzzle_create_user_grid(dst);
+    return true;
+}
+
+/* Exchange two puzzles' layouts, user grids, undo stacks and node arenas;
+   the dictionary and telemetry stay with their owner. Cannot fail, so a
+   live puzzle is only ever replaced by a layout that is already complete. */
+static void swap_layout(Puzzle *a, Puzzle *b) {
+    DictSnapshot *da = a->dict, *db = b->dict;
+    Telemetry *ta = a->telemetry, *tb = b->telemetry;
+    unsigned char *x = (unsigned char *)a, *y = (unsigned char *)b;
+    for (size_t i = 0; i < sizeof(Puzzle); ++i) {
+        unsigned char t = x[i]; x[i] = y[i]; y[i] = t;
+    }
+    a->dict = da; b->dict = db;
+    a->telemetry = ta; b->telemetry = tb;
+    if (a->undo_stack.arena) a->undo_stack.arena = &a->arena;
+    if (b->undo_stack.arena) b->undo_stack.arena = &b->arena;
+}
+
+/* A puzzle is "started" once the player has entered anything; undoing
+   every move does not make it fresh again */
+bool puzzle_started(const Puzzle *p) {
+    return p && p->played;
+}
+
+/* ----------------- Randomised greedy generation ----------------- */
+
+/* Puzzle with its own arena and no dictionary, for building candidates */
+static Puzzle *scratch_puzzle(void) {
+    Puzzle *p = (Puzzle *) calloc(1, sizeof(Puzzle));
+    if (!p) return NULL;
+    arena_init(&p->arena);
+    p->undo_stack.arena = &p->arena;
+    puzzle_init(p);
+    return p;
+}
+
+/* Shuffle, but keep long words early since they anchor the layout */
+static void shuffle_long_first(char **words, int n, unsigned long long *rng) {
+    for (int i = n - 1; i > 0; --i) {
+        int j = (int)(rng_next(rng) % (unsigned long long)(i + 1));
+        char *t = words[i]; words[i] = words[j]; words[j] = t;
+    }
+    for (int i = 1; i < n; ++i) {
+        char *w = words[i];
+        int j = i;
+        int Lw = (int)strlen(w);
+        while (j > 0 && (int)strlen(words[j-1]) + REFINE_LENGTH_SLACK < Lw) { words[j] = words[j-1]; --j; }
+        words[j] = w;
+    }
+}
+
+/* Place w where it crosses the most letters already on the grid */
+static bool place_best_crossing(Puzzle *p, const char *w, unsigned long long *rng) {
+    int Lw = (int)strlen(w);
+    int best_r = -1, best_c = -1, best_x = 0;
+    char best_d = 'A';
+    for (const WordNode *cur = p->positions_head; cur; cur = cur->next) {
+        const WordPos *wp = &cur->data;
+        int L2 = (int)strlen(wp->word);
+        for (int i = 0; i < Lw; ++i) {
+            for (int j = 0; j < L2; ++j) {
+                if (w[i] != wp->word[j]) continue;
+                int nr, nc; char nd;
+                if (wp->direction == 'A') { nr = wp->row - i; nc = wp->col + j; nd = 'D'; }
+                else { nr = wp->row + j; nc = wp->col - i; nd = 'A'; }
+                if (!puzzle_can_place(p, w, nr, nc, nd)) continue;
+                int x = 0;
+                for (int k = 0; k < Lw; ++k) {
+                    int r = nr + (nd == 'D' ? k : 0), c = nc + (nd == 'A' ? k : 0);
+                    if (p->sol[r][c] != ' ') x++;
+                }
+                /* random tie-break so restarts explore different layouts */
+                if (x > best_x || (x == best_x && x > 0 && (rng_next(rng) & 1))) {
+                    best_x = x; best_r = nr; best_c = nc; best_d = nd;
+                }
+            }
+        }
+    }
+    if (best_r < 0) return false;
+    return puzzle_place_word_record(p, w, best_r, best_c, best_d);
+}
+
+/* One randomised greedy pass. The hash after each placement is appended to
+   path[]; the pass gives up (returns false) on reaching a state the table
+   says has repeatedly failed to beat `best`, or once stop is set or the
+   deadline passes (a pass over a big dictionary can take seconds). */
+static bool generate_randomised(Puzzle *p, char **words, int n, unsigned long long *rng,
+                                const TransTable *tt, int best, uint64_t *path, int *depth,
+                                atomic_bool *stop, long long deadline) {
+    puzzle_init(p);
+    *depth = 0;
+    shuffle_long_first(words, n, rng);
+
+    int L0 = (int)strlen(words[0]);
+    char d0 = (rng_next(rng) & 1) ? 'A' : 'D';
+    int mid = GRID_SIZE / 2;
+    int off = (GRID_SIZE - L0) / 2;
+    if (off < 0) off = 0;
+    if (d0 == 'A') (void)puzzle_place_word_record(p, words[0], mid, off, 'A');
+    else (void)puzzle_place_word_record(p, words[0], off, mid, 'D');
+    if (p->word_count == 0) (void)puzzle_place_anywhere(p, words[0]);
+    if (p->word_count > 0) path[(*depth)++] = p->hash;
+
+    for (int i = 1; i < n; ++i) {
+        if (atomic_load(stop) || monotonic_ns() >= deadline) return false;
+        if (!place_best_crossing(p, words[i], rng) && !puzzle_place_anywhere(p, words[i])) continue;
+        path[(*depth)++] = p->hash;
+        if (*depth >= TT_MIN_PRUNE_DEPTH && tt_is_dead(tt, p->hash, best)) return false;
+    }
+    return true;
+}
+
+/* ----------------- Neighbourhood repair ----------------- */
+
+typedef struct {
+    Puzzle *best;                /* layout being improved */
+    int best_score;
+    Puzzle *work;                /* scratch for each attempt; swapped with best on success */
+    const DictSnapshot *dict;
+    TransTable *tt;              /* keyed by the grid left after removal */
+    unsigned long long *rng;
+    int neighbourhood;
+    char **cand;                 /* neighbourhood + REPAIR_CANDIDATES slots */
+    char removed[REPAIR_MAX_NEIGHBOURHOOD][MAX_WORD_LENGTH];
+} Repair;
+
+static int word_crossings(const Puzzle *p, const WordPos *wp) {
+    int L = (int)strlen(wp->word), x = 0;
+    for (int k = 0; k < L; ++k) {
+        int r = wp->row + (wp->direction == 'D' ? k : 0);
+        int c = wp->col + (wp->direction == 'A' ? k : 0);
+        if (p->owner[r][c] == (OWNER_ACROSS | OWNER_DOWN)) x++;
+    }
+    return x;
+}
+
+static bool on_grid(const Puzzle *p, const char *w) {
+    for (const WordNode *cur = p->positions_head; cur; cur = cur->next)
+        if (strcmp(cur->data.word, w) == 0) return true;
+    return false;
+}
+
+/* Twice the word's midpoint, so distances stay integral */
+static void word_mid2(const WordPos *wp, int *r2, int *c2) {
+    int L = (int)strlen(wp->word) - 1;
+    *r2 = 2 * wp->row + (wp->direction == 'D' ? L : 0);
+    *c2 = 2 * wp->col + (wp->direction == 'A' ? L : 0);
+}
+
+/* Least-connected word (random tie-break); now and then any word, so the
+   search does not keep digging at the same spot */
+static const WordPos *pick_seed(const Puzzle *p, unsigned long long *rng) {
+    const WordPos *seed = NULL;
+    int best_x = 0, ties = 0, i = 0;
+    bool uniform = (rng_next(rng) & 3) == 0;
+    for (const WordNode *cur = p->positions_head; cur; cur = cur->next, ++i) {
+        int x = uniform ? 0 : word_crossings(p, &cur->data);
+        if (!seed || x < best_x) { seed = &cur->data; best_x = x; ties = 1; }
+        else if (x == best_x && rng_next(rng) % (unsigned long long)++ties == 0) seed = &cur->data;
+    }
+    return seed;
+}
+
+/* One destroy-and-refill attempt on a copy of rp->best; true if it improved */
+static bool repair_step(Repair *rp) {
+    Puzzle *w = rp->work;
+    if (!puzzle_copy_layout(w, rp->best) || w->word_count == 0) return false;
+
+    /* the seed and its nearest neighbours by midpoint distance */
+    const WordPos *seed = pick_seed(w, rp->rng);
+    int sr, sc;
+    word_mid2(seed, &sr, &sc);
+    int k = rp->neighbourhood < w->word_count ? rp->neighbourhood : w->word_count;
+    const WordPos *pick[REPAIR_MAX_NEIGHBOURHOOD];
+    for (int n = 0; n < k; ++n) {
+        const WordPos *near = NULL;
+        int near_d = 0;
+        for (const WordNode *cur = w->positions_head; cur; cur = cur->next) {
+            bool taken = false;
+            for (int t = 0; t < n && !taken; ++t) taken = pick[t] == &cur->data;
+            if (taken) continue;
+            int r2, c2;
+            word_mid2(&cur->data, &r2, &c2);
+            int d = abs(r2 - sr) + abs(c2 - sc);
+            if (!near || d < near_d) { near = &cur->data; near_d = d; }
+        }
+        pick[n] = near;
+    }
+
+    int clue[REPAIR_MAX_NEIGHBOURHOOD];
+    char dir[REPAIR_MAX_NEIGHBOURHOOD];
+    for (int n = 0; n < k; ++n) {
+        strcpy(rp->removed[n], pick[n]->word);
+        clue[n] = pick[n]->clue_num;
+        dir[n] = pick[n]->direction;
+    }
+    bool touching = false;
+    for (int n = 0; n < k; ++n)
+        if (puzzle_unplace_word(w, clue[n], dir[n]) == UNPLACE_TOUCHING) touching = true;
+
+    /* this hole has been refilled often enough without beating best */
+    uint64_t hole = w->hash;
+    if (tt_is_dead(rp->tt, hole, rp->best_score)) return false;
+    /* two kept words touch: not a legal grid, and refills almost never mend
+       it, so don't try this hole again */
+    if (touching) {
+        tt_mark_dead(rp->tt, hole);
+        return false;
+    }
+
+    /* refill from the removed words plus a sample of unused dictionary words */
+    int nc = 0;
+    for (int n = 0; n < k; ++n) rp->cand[nc++] = rp->removed[n];
+    for (int n = 0; n < REPAIR_CANDIDATES && n < rp->dict->count; ++n) {
+        char *dw = rp->dict->by_length[rng_next(rp->rng) % (unsigned long long)rp->dict->count];
+        if (!on_grid(w, dw)) rp->cand[nc++] = dw;
+    }
+    shuffle_long_first(rp->cand, nc, rp->rng);
+    for (int n = 0; n < nc; ++n) {
+        const char *cw = rp->cand[n];
+        if (on_grid(w, cw)) continue;   /* sampled twice */
+        if (place_best_crossing(w, cw, rp->rng)) continue;
+        /* removed words may go anywhere, as in the greedy generator; new
+           words must cross so the hole is not filled with islands */
+        bool was_removed = false;
+        for (int t = 0; t < k && !was_removed; ++t) was_removed = strcmp(cw, rp->removed[t]) == 0;
+        if (was_removed || w->word_count == 0) (void)puzzle_place_anywhere(w, cw);
+    }
+
+    int score = puzzle_layout_score(w);
+    tt_record(rp->tt, hole, score);
+    if (score <= rp->best_score) return false;
+    /* every placement passed puzzle_can_place, so w is a legal layout */
+    rp->work = rp->best;
+    rp->best = w;
+    rp->best_score = score;
+    return true;
+}
+
+static bool repair_init(Repair *rp, const DictSnapshot *dict, TransTable *tt,
+                        unsigned long long *rng, int neighbourhood) {
+    memset(rp, 0, sizeof(*rp));
+    if (neighbourhood < 1) neighbourhood = 1;
+    if (neighbourhood > REPAIR_MAX_NEIGHBOURHOOD) neighbourhood = REPAIR_MAX_NEIGHBOURHOOD;
+    rp->dict = dict;
+    rp->tt = tt;
+    rp->rng = rng;
+    rp->neighbourhood = neighbourhood;
+    rp->work = scratch_puzzle();
+    rp->cand = (char **) malloc((size_t)(neighbourhood + REPAIR_CANDIDATES) * sizeof(char *));
+    return rp->work && rp->cand;
+}
+
+/* rp->best is the caller's (it may have been swapped with the scratch
+   puzzle; either way the caller frees rp->best and this frees rp->work) */
+static void repair_release(Repair *rp) {
+    puzzle_free(rp->work);
+    free(rp->cand);
+}
+
+/* Improve p's layout in place for up to budget_sec by repeatedly lifting
+   `neighbourhood` neighbouring words and refilling the hole. Only for a
+   puzzle the player has not started. Returns true if p was changed. */
+bool puzzle_repair(Puzzle *p, double budget_sec, int neighbourhood) {
+    if (!p || !p->dict || p->dict->count <= 0 || budget_sec <= 0.0) return false;
+    if (puzzle_started(p) || p->word_count == 0) return false;
+    long long deadline = monotonic_ns() + (long long)(budget_sec * 1e9);
+    unsigned long long rng = (unsigned long long)monotonic_ns() ^ (unsigned long long)(size_t)p;
+    if (rng == 0) rng = 0x9E3779B97F4A7C15ULL;
+
+    TransTable *tt = tt_create(TT_ENTRIES_DEFAULT);
+    Repair rp;
+    bool ready = repair_init(&rp, p->dict, tt, &rng, neighbourhood);
+    rp.best = scratch_puzzle();
+    bool improved = false;
+    if (tt && ready && rp.best && puzzle_copy_layout(rp.best, p)) {
+        int start_score = rp.best_score = puzzle_layout_score(p);
+        while (monotonic_ns() < deadline) (void)repair_step(&rp);
+        if (rp.best_score > start_score) {
+            swap_layout(p, rp.best);   /* rp.best now holds the old layout */
+            puzzle_create_user_grid(p);
+            p->start_ns = monotonic_ns();
+            improved = true;
+        }
+    }
+    puzzle_free(rp.best);
+    repair_release(&rp);
+    tt_free(tt);
+    return improved;
+}
+
+/* ----------------- Background refiner ----------------- */
+
+/* Hand a copy of src to the game thread */
+static bool publish(Refiner *rf, const Puzzle *src) {
+    Puzzle *cand = scratch_puzzle();
+    if (!cand) return false;
+    if (!puzzle_copy_layout(cand, src)) { puzzle_free(cand); return true; }
+    Puzzle *old = atomic_exchange(&rf->best, cand);
+    puzzle_free(old);   /* superseded before the game thread took it */
+    return true;
+}
+
+static void *refiner_main(void *arg) {
+    Refiner *rf = (Refiner *)arg;
+    Puzzle *work = scratch_puzzle();
+    int n = rf->dict->count;
+    char **order = (char **) malloc((size_t)n * sizeof(char *));
+    uint64_t *path = (uint64_t *) malloc((size_t)n * sizeof(uint64_t));
+    if (!work || !order || !path) {
+        puzzle_free(work);
+        free(order);
+        free(path);
+        return NULL;
+    }
+    memcpy(order, rf->dict->by_length, (size_t)n * sizeof(char *));
+
+    while (!atomic_load(&rf->stop) && monotonic_ns() < rf->repair_from_ns) {
+        int depth = 0;
+        if (!generate_randomised(work, order, n, &rf->rng, rf->tt, rf->best_score, path, &depth,
+                                 &rf->stop, rf->repair_from_ns))
+            continue;
+        /* the table may know this grid only as a midpoint of another restart,
+           so always score it; the probe just spots a layout already published */
+        int score = puzzle_layout_score(work);
+        const TTEntry *seen = tt_probe(rf->tt, work->hash);
+        bool duplicate = seen && seen->best >= score;
+        for (int i = 0; i < depth; ++i) tt_record(rf->tt, path[i], score);
+        if (duplicate || score <= rf->best_score) continue;
+        if (!puzzle_copy_layout(rf->base, work)) continue;
+        rf->best_score = score;
+        if (!publish(rf, rf->base)) break;
+    }
+
+    /* then polish the best layout so far */
+    Repair rp;
+    if (repair_init(&rp, rf->dict, rf->tt, &rf->rng, REPAIR_NEIGHBOURHOOD_DEFAULT)) {
+        rp.best = rf->base;
+        rp.best_score = rf->best_score;
+        while (!atomic_load(&rf->stop) && monotonic_ns() < rf->deadline_ns) {
+            if (!repair_step(&rp)) continue;
+            rf->best_score = rp.best_score;
+            if (!publish(rf, rp.best)) break;
+        }
+        rf->base = rp.best;   /* steps swap best with their scratch puzzle */
+    }
+    repair_release(&rp);
+
+    puzzle_free(work);
+    free(order);
+    free(path);
+    return NULL;
+}
+
+Refiner *puzzle_refine_start(Puzzle *p, double budget_sec) {
+    if (!p || !p->dict || p->dict->count <= 0 || budget_sec <= 0.0) return NULL;
+    Refiner *rf = (Refiner *) calloc(1, sizeof(Refiner));
+    if (!rf) return NULL;
+    rf->tt = tt_create(TT_ENTRIES_DEFAULT);
+    rf->base = scratch_puzzle();
+    if (!rf->tt || !rf->base || !puzzle_copy_layout(rf->base, p)) {
+        tt_free(rf->tt);
+        puzzle_free(rf->base);
+        free(rf);
+        return NULL;
+    }
+    dict_snapshot_retain(p->dict);
+    rf->dict = p->dict;
+    rf->best_score = puzzle_layout_score(p);
+    long long now = monotonic_ns();
+    rf->deadline_ns = now + (long long)(budget_sec * 1e9);
+    rf->repair_from_ns = now + (long long)(budget_sec * (1.0 - REFINE_REPAIR_SHARE) * 1e9);
+    /* a whole-grid restart on a poster grid takes far longer than the budget,
+       and would throw away the tiled layout anyway: only repair it */
+    if (GRID_SIZE > TILE_SIZE_DEFAULT) rf->repair_from_ns = now;
+    rf->rng = (unsigned long long)monotonic_ns() ^ (unsigned long long)(size_t)rf;
+    if (rf->rng == 0) rf->rng = 0x9E3779B97F4A7C15ULL;
+    atomic_init(&rf->stop, false);
+    atomic_init(&rf->best, NULL);
+    if (pthread_create(&rf->thread, NULL, refiner_main, rf) != 0) {
+        dict_snapshot_release(rf->dict);
+        tt_free(rf->tt);
+        puzzle_free(rf->base);
+        free(rf);
+        return NULL;
+    }
+    rf->running = true;
+    return rf;
+}
+
+/* Adopt the best layout found so far if the player hasn't started.
+   Returns true if p's layout was replaced. */
+bool puzzle_refine_poll(Refiner *rf, Puzzle *p) {
+    if (!rf || !p) return false;
+    if (atomic_load(&rf->stop)) return false;   /* the player started earlier: never swap again */
+    if (puzzle_started(p)) {
+        /* too late to swap; no point searching further */
+        atomic_store(&rf->stop, true);
+        return false;
+    }
+    Puzzle *cand = atomic_exchange(&rf->best, NULL);
+    if (!cand) return false;
+    /* cand was built in full by the refiner; p is never left half-copied */
+    swap_layout(p, cand);
+    puzzle_free(cand);
+    p->start_ns = monotonic_ns();
+    return true;
+}
+
+void puzzle_refine_stop(Refiner *rf) {
+    if (!rf) return;
+    atomic_store(&rf->stop, true);
+    if (rf->running) pthread_join(rf->thread, NULL);
+    puzzle_free(atomic_exchange(&rf->best, NULL));
+    puzzle_free(rf->base);
+    dict_snapshot_release(rf->dict);
+    tt_free(rf->tt);
+    free(rf);
+}
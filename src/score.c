@@ -0,0 +1,171 @@
+/* src/score.c
+ *
+ * Batch scoring of user grids against their solutions.
+ *
+ * Each grid is compared as one flat run of GRID_SIZE*GRID_SIZE bytes, 16 at a
+ * time (SSE2 where available, 8-byte SWAR otherwise). The comparisons are
+ * packed into bitmasks -- cell matches, letter cells, blank user cells -- and
+ * completion comes from popcounts of those masks. Per-word correctness is
+ * read straight off the match mask: an Across word is a contiguous bit range,
+ * a Down word is every GRID_SIZE-th bit.
+ *
+ * puzzle_completion and puzzle_solved use the same kernel for one puzzle.
+ */
+
+#include "../include/crossword.h"
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define SCORE_CELLS      (GRID_SIZE * GRID_SIZE)
+#define SCORE_MASK_WORDS ((SCORE_CELLS + 63) / 64)
+
+typedef struct {
+    uint64_t match[SCORE_MASK_WORDS];    /* user == sol */
+    uint64_t letter[SCORE_MASK_WORDS];   /* sol holds a letter */
+    uint64_t blank[SCORE_MASK_WORDS];    /* user is '_' or ' ' */
+} ScoreMasks;
+
+/* ----------------- 16-byte compare kernels ----------------- */
+
+#if defined(__SSE2__)
+
+/* Bit i set where a[i] == b[i] */
+static unsigned eq16(const char *a, const char *b) {
+    __m128i x = _mm_loadu_si128((const __m128i *)a);
+    __m128i y = _mm_loadu_si128((const __m128i *)b);
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y));
+}
+
+/* Bit i set where a[i] == ch */
+static unsigned eq16c(const char *a, char ch) {
+    __m128i x = _mm_loadu_si128((const __m128i *)a);
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, _mm_set1_epi8(ch)));
+}
+
+#else
+
+/* High bit of each byte set where that byte of x is zero */
+static uint64_t zero_bytes(uint64_t x) {
+    const uint64_t lo7 = 0x7F7F7F7F7F7F7F7FULL;
+    return ~(((x & lo7) + lo7) | x | lo7);
+}
+
+/* Gather the 8 per-byte high bits into the low 8 bits, byte 0 first */
+static unsigned pack_high_bits(uint64_t m) {
+    return (unsigned)(((m >> 7) * 0x0102040810204080ULL) >> 56);
+}
+
+static unsigned eq8(uint64_t x, uint64_t y) {
+    return pack_high_bits(zero_bytes(x ^ y));
+}
+
+static unsigned eq16(const char *a, const char *b) {
+    uint64_t x[2], y[2];
+    memcpy(x, a, 16);
+    memcpy(y, b, 16);
+    return eq8(x[0], y[0]) | eq8(x[1], y[1]) << 8;
+}
+
+static unsigned eq16c(const char *a, char ch) {
+    uint64_t x[2];
+    uint64_t y = 0x0101010101010101ULL * (unsigned char)ch;
+    memcpy(x, a, 16);
+    return eq8(x[0], y) | eq8(x[1], y) << 8;
+}
+
+#endif
+
+/* ----------------- Masks ----------------- */
+
+static void build_masks(const Puzzle *p, ScoreMasks *m) {
+    const char *sol = &p->sol[0][0];
+    const char *user = &p->user[0][0];
+    memset(m, 0, sizeof(*m));
+    int i = 0;
+    for (; i + 16 <= SCORE_CELLS; i += 16) {
+        uint64_t eq = eq16(user, sol);
+        uint64_t let = ~eq16c(sol, ' ') & 0xFFFFu;
+        uint64_t blk = eq16c(user, '_') | eq16c(user, ' ');
+        m->match[i >> 6] |= eq << (i & 63);
+        m->letter[i >> 6] |= let << (i & 63);
+        m->blank[i >> 6] |= blk << (i & 63);
+        user += 16;
+        sol += 16;
+    }
+    for (; i < SCORE_CELLS; ++i, ++user, ++sol) {
+        uint64_t bit = 1ULL << (i & 63);
+        if (*user == *sol) m->match[i >> 6] |= bit;
+        if (*sol != ' ') m->letter[i >> 6] |= bit;
+        if (*user == '_' || *user == ' ') m->blank[i >> 6] |= bit;
+    }
+}
+
+static bool test_bit(const uint64_t *m, int i) {
+    return (m[i >> 6] >> (i & 63)) & 1;
+}
+
+/* All of bits [s, s+len) set; len < 64 */
+static bool range_set(const uint64_t *m, int s, int len) {
+    uint64_t want = (1ULL << len) - 1;
+    int w = s >> 6, o = s & 63;
+    uint64_t v = m[w] >> o;
+    if (o + len > 64) v |= m[w + 1] << (64 - o);
+    return (v & want) == want;
+}
+
+static bool word_correct(const ScoreMasks *m, const WordPos *wp) {
+    int L = (int)strlen(wp->word);
+    int s = wp->row * GRID_SIZE + wp->col;
+    if (wp->direction == 'A') return range_set(m->match, s, L);
+    for (int k = 0; k < L; ++k)
+        if (!test_bit(m->match, s + k * GRID_SIZE)) return false;
+    return true;
+}
+
+/* ----------------- Scoring ----------------- */
+
+static void score_one(const Puzzle *p, PuzzleScore *out) {
+    unsigned char *word_ok = out->word_ok;
+    memset(out, 0, sizeof(*out));
+    out->word_ok = word_ok;
+    if (!p) return;
+
+    ScoreMasks m;
+    build_masks(p, &m);
+    bool filled = true;
+    for (int w = 0; w < SCORE_MASK_WORDS; ++w) {
+        out->cells_total += __builtin_popcountll(m.letter[w]);
+        out->cells_correct += __builtin_popcountll(m.match[w] & m.letter[w]);
+        if (m.blank[w] & m.letter[w]) filled = false;
+    }
+    out->completion = out->cells_total
+        ? (float)out->cells_correct * 100.0f / (float)out->cells_total : 0.0f;
+
+    int i = 0;
+    for (const WordNode *cur = p->positions_head; cur; cur = cur->next, ++i) {
+        bool ok = word_correct(&m, &cur->data);
+        if (word_ok) word_ok[i] = ok;
+        out->words_correct += ok;
+    }
+    out->words_total = i;
+
+    /* an exact match is solved; a different full fill must pass the clue check */
+    if (out->cells_correct == out->cells_total) out->solved = true;
+    else out->solved = filled && puzzle_fill_valid(p);
+}
+
+/* Score n grids in one pass. out[i].word_ok may point at a caller buffer
+   with room for ps[i]->word_count flags (clue order), or be NULL. */
+void puzzle_score_batch(const Puzzle *const *ps, int n, PuzzleScore *out) {
+    if (!ps || !out) return;
+    for (int i = 0; i < n; ++i) {
+        if (i + 1 < n && ps[i + 1]) {
+            __builtin_prefetch(&ps[i + 1]->sol[0][0]);
+            __builtin_prefetch(&ps[i + 1]->user[0][0]);
+        }
+        score_one(ps[i], &out[i]);
+    }
+}
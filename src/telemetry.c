@@ -0,0 +1,156 @@
+/* src/telemetry.c
+ *
+ * Gameplay telemetry: per-operation latency, per-word solve times, hints.
+ *
+ * Latencies go into HDR-style histograms: values are bucketed by power of two
+ * and each power of two is split into 2^HIST_SUB_BITS linear sub-buckets, so
+ * every recorded value is kept to within ~6% from nanoseconds up to hours in
+ * a fixed 8 KB table. Percentiles are read back from the buckets, which gives
+ * real tail latency (p99, p99.9) rather than averages.
+ *
+ * Export uses the Prometheus text format, so the file can be served as-is or
+ * picked up by a node_exporter textfile collector.
+ */
+
+#include "../include/crossword.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *const op_names[TELE_OP_COUNT] = {
+    "input_answer", "give_hint", "undo_last_move", "draw_grid"
+};
+
+/* ----------------- Histogram ----------------- */
+
+static int hist_index(uint64_t v) {
+    if (v < HIST_SUB_COUNT) return (int)v;
+    int msb = 63 - __builtin_clzll(v);
+    int major = msb - HIST_SUB_BITS + 1;
+    int sub = (int)((v >> (msb - HIST_SUB_BITS)) & (HIST_SUB_COUNT - 1));
+    return (major << HIST_SUB_BITS) + sub;
+}
+
+/* Highest value that falls in bucket idx */
+static uint64_t hist_bucket_high(int idx) {
+    if (idx < HIST_SUB_COUNT) return (uint64_t)idx;
+    int major = idx >> HIST_SUB_BITS;
+    uint64_t sub = (uint64_t)(idx & (HIST_SUB_COUNT - 1));
+    uint64_t lo = (HIST_SUB_COUNT + sub) << (major - 1);
+    return lo + (1ULL << (major - 1)) - 1;
+}
+
+void hist_record(LatencyHist *h, uint64_t v) {
+    if (!h) return;
+    h->counts[hist_index(v)]++;
+    if (h->total == 0 || v < h->min) h->min = v;
+    if (v > h->max) h->max = v;
+    h->total++;
+    h->sum += v;
+}
+
+/* Value at quantile q (0..1); within one bucket width of the true value */
+uint64_t hist_quantile(const LatencyHist *h, double q) {
+    if (!h || h->total == 0) return 0;
+    /* nearest rank: the ceil(q*n)-th smallest value, as a 0-based index */
+    double qn = q * (double)h->total;
+    uint64_t want = (qn > 0.0) ? (uint64_t)qn : 0;
+    if ((double)want < qn) want++;
+    uint64_t rank = (want > 0) ? want - 1 : 0;
+    if (rank >= h->total) rank = h->total - 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < HIST_BUCKETS; ++i) {
+        seen += h->counts[i];
+        if (seen > rank) {
+            uint64_t v = hist_bucket_high(i);
+            return v > h->max ? h->max : v;
+        }
+    }
+    return h->max;
+}
+
+/* ----------------- Telemetry ----------------- */
+
+Telemetry *telemetry_create(void) {
+    return (Telemetry *) calloc(1, sizeof(Telemetry));
+}
+
+void telemetry_free(Telemetry *t) {
+    free(t);
+}
+
+void telemetry_record(Telemetry *t, TelemetryOp op, long long ns) {
+    if (!t || op < 0 || op >= TELE_OP_COUNT) return;
+    hist_record(&t->ops[op], ns > 0 ? (uint64_t)ns : 0);
+}
+
+/* Record first-solve time for every word that just became correct */
+void telemetry_note_progress(Puzzle *p) {
+    if (!p || !p->telemetry) return;
+    long long now = monotonic_ns();
+    for (WordNode *cur = p->positions_head; cur; cur = cur->next) {
+        WordPos *wp = &cur->data;
+        if (wp->solved_ns) continue;
+        int L = (int)strlen(wp->word);
+        bool ok = true;
+        for (int k = 0; k < L && ok; ++k) {
+            int r = wp->row + (wp->direction == 'D' ? k : 0);
+            int c = wp->col + (wp->direction == 'A' ? k : 0);
+            ok = p->user[r][c] == p->sol[r][c];
+        }
+        if (!ok) continue;
+        wp->solved_ns = now - p->start_ns;
+        if (wp->solved_ns <= 0) wp->solved_ns = 1;
+        hist_record(&p->telemetry->word_solve, (uint64_t)wp->solved_ns);
+        p->telemetry->words_solved++;
+        if (wp->hint_used) p->telemetry->words_solved_with_hints++;
+    }
+}
+
+static void write_summary(FILE *f, const char *name, const char *labels, const LatencyHist *h) {
+    static const double qs[] = { 0.5, 0.9, 0.99, 0.999, 1.0 };
+    const char *sep = labels[0] ? "," : "";
+    for (size_t i = 0; i < sizeof(qs)/sizeof(qs[0]); ++i)
+        fprintf(f, "%s{%s%squantile=\"%g\"} %.9f\n", name, labels, sep, qs[i],
+                (double)hist_quantile(h, qs[i]) / 1e9);
+    const char *lb = labels[0] ? "{" : "", *rb = labels[0] ? "}" : "";
+    fprintf(f, "%s_sum%s%s%s %.9f\n", name, lb, labels, rb, (double)h->sum / 1e9);
+    fprintf(f, "%s_count%s%s%s %llu\n", name, lb, labels, rb, (unsigned long long)h->total);
+}
+
+/* Write all metrics in Prometheus text format; the file is replaced atomically */
+bool telemetry_export(const Puzzle *p, const char *path) {
+    if (!p || !p->telemetry || !path) return false;
+    const Telemetry *t = p->telemetry;
+    char tmp[512];
+    if (snprintf(tmp, sizeof(tmp), "%s.tmp", path) >= (int)sizeof(tmp)) return false;
+    FILE *f = fopen(tmp, "w");
+    if (!f) return false;
+
+    fprintf(f, "# HELP pesuzzle_op_latency_seconds Latency of gameplay operations.\n");
+    fprintf(f, "# TYPE pesuzzle_op_latency_seconds summary\n");
+    for (int op = 0; op < TELE_OP_COUNT; ++op) {
+        char labels[64];
+        snprintf(labels, sizeof(labels), "op=\"%s\"", op_names[op]);
+        write_summary(f, "pesuzzle_op_latency_seconds", labels, &t->ops[op]);
+    }
+    fprintf(f, "# HELP pesuzzle_word_solve_seconds Time from puzzle start to each word first solved.\n");
+    fprintf(f, "# TYPE pesuzzle_word_solve_seconds summary\n");
+    write_summary(f, "pesuzzle_word_solve_seconds", "", &t->word_solve);
+    fprintf(f, "# TYPE pesuzzle_hints_used_total counter\n");
+    fprintf(f, "pesuzzle_hints_used_total %d\n", t->hints_used);
+    fprintf(f, "# TYPE pesuzzle_words_solved_total counter\n");
+    fprintf(f, "pesuzzle_words_solved_total %d\n", t->words_solved);
+    fprintf(f, "# TYPE pesuzzle_words_solved_with_hints_total counter\n");
+    fprintf(f, "pesuzzle_words_solved_with_hints_total %d\n", t->words_solved_with_hints);
+    fprintf(f, "# TYPE pesuzzle_words gauge\n");
+    fprintf(f, "pesuzzle_words %d\n", p->word_count);
+
+    bool ok = (fclose(f) == 0);
+#ifdef _WIN32
+    if (ok) remove(path);   /* rename() does not overwrite on Windows */
+#endif
+    if (ok) ok = (rename(tmp, path) == 0);
+    if (!ok) remove(tmp);
+    return ok;
+}
@@ -0,0 +1,350 @@
+/* src/tiles.c
+ *
+ * Tiled parallel generation for large grids (build with -DGRID_SIZE=N).
+ *
+ * The grid is cut into square tiles. Each tile is filled by a worker thread
+ * using only the cells inside the tile, keeping a one-cell blank margin along
+ * the tile border. Because puzzle_can_place only looks one cell around a word,
+ * that margin guarantees a worker never reads or writes a cell owned by
+ * another tile, so tiles need no locking. A tile grows from one seed word
+ * and only adds crossing words; words it could not use are dealt to the
+ * next tile in a further round (TILE_ROUNDS).
+ *
+ * Between neighbouring tiles that margin forms a two-cell gutter. Seams then
+ * join the tiles: each seam covers one stretch of gutter plus the half of
+ * each neighbouring tile next to it, and places leftover words that run
+ * across the gutter and cross letters on both sides. Seams that share a
+ * gutter direction are at least two cells apart, so they run in parallel the
+ * same way tiles do: first every seam across horizontal gutters (Down
+ * words), then every seam across vertical gutters (Across words). Words that
+ * neither a tile nor a seam could use are dropped; a serial whole-grid pass
+ * over them would cost far more than all the parallel work together.
+ *
+ * Worker count defaults to the number of online CPUs.
+ */
+
+#include "../include/crossword.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    int r0, c0, r1, c1;   /* cells words may use, inclusive */
+    char bridge;          /* 0 for a tile; 'D' or 'A' for a seam across a gutter */
+    bool seeded;          /* tile: holds its first word */
+    int gutter;           /* seam: first of its two gutter rows ('D') or columns ('A') */
+    char **words;         /* words dealt to this tile */
+    int word_count;
+    WordPos *placed;      /* words placed by the worker, in order */
+    int placed_count;
+    uint64_t hash;        /* Zobrist delta of this tile's cells */
+} Tile;
+
+typedef void (*TileFill)(Puzzle *p, Tile *t);
+
+typedef struct {
+    Puzzle *p;
+    Tile *tiles;
+    int tile_count;
+    int first;            /* this worker handles tiles first, first+stride, ... */
+    int stride;
+    TileFill fill;
+} TileWorker;
+
+/* Word fits entirely inside the tile interior */
+static bool tile_contains(const Tile *t, int L, int r, int c, char d) {
+    if (r < t->r0 || c < t->c0) return false;
+    if (d == 'A') return r <= t->r1 && c + L - 1 <= t->c1;
+    return c <= t->c1 && r + L - 1 <= t->r1;
+}
+
+static bool tile_place(Puzzle *p, Tile *t, const char *w, int r, int c, char d) {
+    int L = (int)strlen(w);
+    if (!tile_contains(t, L, r, c, d)) return false;
+    if (!puzzle_can_place(p, w, r, c, d)) return false;
+    t->hash ^= puzzle_stamp_word(p, w, r, c, d);
+    WordPos *wp = &t->placed[t->placed_count++];
+    strncpy(wp->word, w, MAX_WORD_LENGTH-1);
+    wp->word[MAX_WORD_LENGTH-1] = '\0';
+    wp->row = r; wp->col = c; wp->direction = d;
+    wp->clue_num = 0;
+    wp->hint_used = false;
+    wp->solved_ns = 0;
+    return true;
+}
+
+/* Same search as puzzle_find_intersection, restricted to letters inside
+   the tile (including words placed in earlier rounds) */
+static bool tile_place_crossing(Puzzle *p, Tile *t, const char *w) {
+    int Lw = (int)strlen(w);
+    for (int r = t->r0; r <= t->r1; ++r) {
+        for (int c = t->c0; c <= t->c1; ++c) {
+            char ch = p->sol[r][c];
+            if (ch == ' ' || p->owner[r][c] == (OWNER_ACROSS | OWNER_DOWN)) continue;
+            char nd = (p->owner[r][c] & OWNER_ACROSS) ? 'D' : 'A';
+            for (int i = 0; i < Lw; ++i) {
+                if (w[i] != ch) continue;
+                int nr = (nd == 'D') ? r - i : r, nc = (nd == 'A') ? c - i : c;
+                if (tile_place(p, t, w, nr, nc, nd)) return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* Seed an empty tile with one word, then only add words that cross it, so
+   each tile grows as one connected block */
+static void tile_fill(Puzzle *p, Tile *t) {
+    for (int i = 0; i < t->word_count; ++i) {
+        const char *w = t->words[i];
+        int L = (int)strlen(w);
+        if (t->seeded) {
+            (void)tile_place_crossing(p, t, w);
+            continue;
+        }
+        /* seed: first word across the middle of the tile */
+        int sr = (t->r0 + t->r1) / 2;
+        int sc = t->c0 + ((t->c1 - t->c0 + 1) - L) / 2;
+        bool placed = tile_place(p, t, w, sr, sc, 'A');
+        for (int r = t->r0; r <= t->r1 && !placed; ++r)
+            for (int c = t->c0; c <= t->c1 && !placed; ++c)
+                placed = tile_place(p, t, w, r, c, 'A') || tile_place(p, t, w, r, c, 'D');
+        t->seeded = placed;
+    }
+}
+
+/* Place w across the seam's gutter where it crosses the most letters,
+   needing at least one letter on each side so it actually joins the tiles */
+static bool seam_place_bridge(Puzzle *p, Tile *t, const char *w) {
+    bool down = (t->bridge == 'D');
+    unsigned char same = down ? OWNER_DOWN : OWNER_ACROSS;
+    int g = t->gutter;
+    int L = (int)strlen(w);
+    int best_x = 0, best_r = -1, best_c = -1;
+    for (int r = t->r0; r <= t->r1; ++r) {
+        for (int c = t->c0; c <= t->c1; ++c) {
+            char ch = p->sol[r][c];
+            if (ch == ' ' || (p->owner[r][c] & same)) continue;
+            int along = down ? r : c;
+            for (int i = 0; i < L; ++i) {
+                if (w[i] != ch) continue;
+                int s = along - i;
+                if (s > g || s + L - 1 < g + 1) continue;   /* must cover both gutter lines */
+                int before = 0, after = 0;
+                for (int k = 0; k < L; ++k) {
+                    int rr = down ? s + k : r, cc = down ? c : s + k;
+                    if (rr < 0 || cc < 0 || rr >= GRID_SIZE || cc >= GRID_SIZE) { before = 0; break; }
+                    if (p->sol[rr][cc] == ' ') continue;
+                    if (s + k < g) before++;
+                    else if (s + k > g + 1) after++;
+                }
+                if (!before || !after || before + after <= best_x) continue;
+                int nr = down ? s : r, nc = down ? c : s;
+                if (!tile_contains(t, L, nr, nc, t->bridge) || !puzzle_can_place(p, w, nr, nc, t->bridge)) continue;
+                best_x = before + after;
+                best_r = nr;
+                best_c = nc;
+            }
+        }
+    }
+    return best_x > 0 && tile_place(p, t, w, best_r, best_c, t->bridge);
+}
+
+static void seam_fill(Puzzle *p, Tile *t) {
+    for (int i = 0; i < t->word_count; ++i) (void)seam_place_bridge(p, t, t->words[i]);
+}
+
+static void *tile_worker_main(void *arg) {
+    TileWorker *tw = (TileWorker *)arg;
+    for (int i = tw->first; i < tw->tile_count; i += tw->stride)
+        tw->fill(tw->p, &tw->tiles[i]);
+    return NULL;
+}
+
+/* Fill n independent regions on up to `threads` threads, then merge their
+   words into the puzzle in region order (assigns clue numbers). Regions
+   cover disjoint cells, so their hashes combine by XOR. */
+static void run_tiles(Puzzle *p, Tile *tiles, int n, int threads, TileFill fill) {
+    if (n <= 0) return;
+    if (threads > n) threads = n;
+    TileWorker *workers = (TileWorker *) malloc((size_t)threads * sizeof(TileWorker));
+    pthread_t *tids = (pthread_t *) malloc((size_t)threads * sizeof(pthread_t));
+    int spawned = 0;
+    if (workers && tids && threads > 1) {
+        for (int k = 0; k < threads; ++k) {
+            workers[k] = (TileWorker){ p, tiles, n, k, threads, fill };
+            if (pthread_create(&tids[k], NULL, tile_worker_main, &workers[k]) != 0) break;
+            spawned++;
+        }
+    }
+    if (spawned == 0) {
+        TileWorker self = { p, tiles, n, 0, 1, fill };
+        tile_worker_main(&self);
+    } else {
+        for (int k = 0; k < spawned; ++k) pthread_join(tids[k], NULL);
+        /* regions whose worker failed to start */
+        if (spawned < threads) {
+            for (int i = 0; i < n; ++i)
+                if (i % threads >= spawned) fill(p, &tiles[i]);
+        }
+    }
+    free(workers);
+    free(tids);
+
+    for (int k = 0; k < n; ++k) {
+        p->hash ^= tiles[k].hash;
+        for (int i = 0; i < tiles[k].placed_count; ++i) {
+            const WordPos *wp = &tiles[k].placed[i];
+            (void)puzzle_append_record(p, wp->word, wp->row, wp->col, wp->direction);
+        }
+    }
+}
+
+static bool tile_fits(const Tile *t, int L) {
+    if (t->bridge == 'D') return L >= 4 && L <= t->r1 - t->r0 + 1;
+    if (t->bridge == 'A') return L >= 4 && L <= t->c1 - t->c0 + 1;
+    return L <= t->c1 - t->c0 + 1 || L <= t->r1 - t->r0 + 1;
+}
+
+/* Deal words (longest first) round-robin, starting at region `first`, to
+   regions that can hold them.
+   dealt and placed need room for wc entries; home[i] is -1 if no region fits. */
+static void deal_words(Tile *tiles, int n, char **words, int wc, int first,
+                       char **dealt, WordPos *placed, int *home) {
+    int next = first % n;
+    for (int k = 0; k < n; ++k) tiles[k].word_count = 0;
+    for (int i = 0; i < wc; ++i) {
+        int L = (int)strlen(words[i]);
+        home[i] = -1;
+        for (int tries = 0; tries < n; ++tries) {
+            int k = (next + tries) % n;
+            if (tile_fits(&tiles[k], L)) {
+                home[i] = k;
+                tiles[k].word_count++;
+                next = (k + 1) % n;
+                break;
+            }
+        }
+    }
+    int off = 0;
+    for (int k = 0; k < n; ++k) {
+        tiles[k].words = dealt + off;
+        tiles[k].placed = placed + off;
+        tiles[k].placed_count = 0;
+        tiles[k].hash = 0;
+        off += tiles[k].word_count;
+        tiles[k].word_count = 0;
+    }
+    for (int i = 0; i < wc; ++i)
+        if (home[i] >= 0) tiles[home[i]].words[tiles[home[i]].word_count++] = words[i];
+}
+
+/* Was this word placed by its tile? (words are dealt to exactly one tile) */
+static bool tile_has_word(const Tile *t, const char *w) {
+    for (int k = 0; k < t->placed_count; ++k)
+        if (t->placed[k].word[0] == w[0] && strcmp(t->placed[k].word, w) == 0) return true;
+    return false;
+}
+
+/* Compact words[] to those its regions did not place; returns the new count */
+static int keep_leftovers(const Tile *tiles, char **words, int wc, const int *home) {
+    int n = 0;
+    for (int i = 0; i < wc; ++i)
+        if (home[i] < 0 || !tile_has_word(&tiles[home[i]], words[i])) words[n++] = words[i];
+    return n;
+}
+
+bool puzzle_generate_tiled(Puzzle *p, char **words, int count, int tile_size, int threads) {
+    if (!p || !words || count <= 0) return false;
+    if (tile_size < TILE_MIN_SIZE) tile_size = TILE_MIN_SIZE;
+    if (tile_size > GRID_SIZE) tile_size = GRID_SIZE;
+    if (threads < 1) threads = online_cpus();
+
+    char **tmp = (char **) malloc((size_t)count * sizeof(char *));
+    if (!tmp) return false;
+    int wc = 0;
+    for (int i = 0; i < count; ++i)
+        if (words[i] && words[i][0] != '\0') tmp[wc++] = words[i];
+    if (wc == 0) { free(tmp); return false; }
+    qsort(tmp, (size_t)wc, sizeof(char *), cmp_len_desc);
+
+    /* a remainder strip too thin for a tile of its own joins the last one */
+    int per_side = GRID_SIZE / tile_size;
+    if (GRID_SIZE % tile_size >= TILE_MIN_SIZE) per_side++;
+    int tile_count = per_side * per_side;
+    int seam_count = (per_side - 1) * per_side;   /* per gutter direction */
+    Tile *tiles = (Tile *) calloc((size_t)tile_count, sizeof(Tile));
+    Tile *seams = (Tile *) calloc((size_t)(seam_count > 0 ? seam_count : 1), sizeof(Tile));
+    char **dealt = (char **) malloc((size_t)wc * sizeof(char *));
+    WordPos *placed = (WordPos *) malloc((size_t)wc * sizeof(WordPos));
+    int *home = (int *) malloc((size_t)wc * sizeof(int));
+    if (!tiles || !seams || !dealt || !placed || !home || !puzzle_init(p)) {
+        free(tiles); free(seams); free(dealt); free(placed); free(home); free(tmp);
+        return false;
+    }
+
+    /* tile interiors leave a blank margin on every side shared with another tile */
+    for (int tr = 0; tr < per_side; ++tr) {
+        for (int tc = 0; tc < per_side; ++tc) {
+            Tile *t = &tiles[tr * per_side + tc];
+            int r0 = tr * tile_size, c0 = tc * tile_size;
+            int r1 = r0 + tile_size - 1, c1 = c0 + tile_size - 1;
+            if (tr == per_side - 1 || r1 >= GRID_SIZE) r1 = GRID_SIZE - 1;
+            if (tc == per_side - 1 || c1 >= GRID_SIZE) c1 = GRID_SIZE - 1;
+            t->r0 = (r0 > 0) ? r0 + 1 : r0;
+            t->c0 = (c0 > 0) ? c0 + 1 : c0;
+            t->r1 = (r1 < GRID_SIZE - 1) ? r1 - 1 : r1;
+            t->c1 = (c1 < GRID_SIZE - 1) ? c1 - 1 : c1;
+        }
+    }
+
+    /* A tile only sees the words dealt to it, so words it cannot use are
+       dealt again, each to the next tile over; words too long for any tile
+       are left for the seams. */
+    for (int round = 0; round < TILE_ROUNDS && wc > 0; ++round) {
+        int before = p->word_count;
+        deal_words(tiles, tile_count, tmp, wc, round, dealt, placed, home);
+        run_tiles(p, tiles, tile_count, threads, tile_fill);
+        wc = keep_leftovers(tiles, tmp, wc, home);
+        if (p->word_count == before) break;
+    }
+
+    /* Seams reach `reach` cells past each gutter line, which keeps two seams
+       along the same direction two cells apart: neither reads what the other
+       writes. Down seams first, then Across seams, which read the gutter rows
+       the Down seams filled but write only inside tile rows. */
+    int reach = (tile_size - 3) / 2;
+    for (int pass = 0; pass < 2 && seam_count > 0 && wc > 0; ++pass) {
+        bool down = (pass == 0);
+        for (int g = 0; g < per_side - 1; ++g) {
+            for (int k = 0; k < per_side; ++k) {
+                Tile *s = &seams[g * per_side + k];
+                const Tile *t = down ? &tiles[k] : &tiles[k * per_side];   /* tile column/row k */
+                int line = (g + 1) * tile_size - 1;
+                int lo = line - reach, hi = line + 1 + reach;
+                if (lo < 0) lo = 0;
+                if (hi > GRID_SIZE - 1) hi = GRID_SIZE - 1;
+                memset(s, 0, sizeof(*s));
+                s->bridge = down ? 'D' : 'A';
+                s->gutter = line;
+                s->r0 = down ? lo : t->r0;
+                s->r1 = down ? hi : t->r1;
+                s->c0 = down ? t->c0 : lo;
+                s->c1 = down ? t->c1 : hi;
+            }
+        }
+        for (int round = 0; round < TILE_ROUNDS && wc > 0; ++round) {
+            int before = p->word_count;
+            deal_words(seams, seam_count, tmp, wc, round, dealt, placed, home);
+            run_tiles(p, seams, seam_count, threads, seam_fill);
+            wc = keep_leftovers(seams, tmp, wc, home);
+            if (p->word_count == before) break;
+        }
+    }
+
+    puzzle_create_user_grid(p);
+    p->start_ns = monotonic_ns();
+    free(tiles); free(seams); free(dealt); free(placed); free(home); free(tmp);
+    return p->word_count > 0;
+}
@@ -0,0 +1,80 @@
+/* src/ttable.c
+ *
+ * Transposition table keyed by the Zobrist hash of a (partial) layout.
+ *
+ * Search-based generators (the background refiner, layout repair) reach the
+ * same grid state through different word orders. The table remembers, for
+ * each state seen, the best final score reached from it and how often it was
+ * tried, so a search can skip states that keep leading nowhere.
+ *
+ * Fixed size, 2-entry buckets: a new state goes into an empty or matching
+ * slot, otherwise it replaces the less-visited entry of the bucket.
+ */
+
+#include "../include/crossword.h"
+#include <stdlib.h>
+
+TransTable *tt_create(size_t entries) {
+    size_t n = 2;
+    while (n < entries) n <<= 1;
+    TransTable *tt = (TransTable *) malloc(sizeof(TransTable));
+    if (!tt) return NULL;
+    tt->slots = (TTEntry *) calloc(n, sizeof(TTEntry));
+    if (!tt->slots) { free(tt); return NULL; }
+    tt->mask = n - 1;
+    return tt;
+}
+
+void tt_free(TransTable *tt) {
+    if (!tt) return;
+    free(tt->slots);
+    free(tt);
+}
+
+static TTEntry *tt_bucket(const TransTable *tt, uint64_t key) {
+    return &tt->slots[(size_t)key & tt->mask & ~(size_t)1];
+}
+
+const TTEntry *tt_probe(const TransTable *tt, uint64_t key) {
+    if (!tt || key == 0) return NULL;
+    const TTEntry *b = tt_bucket(tt, key);
+    if (b[0].key == key) return &b[0];
+    if (b[1].key == key) return &b[1];
+    return NULL;
+}
+
+/* Find the slot for key, claiming (and clearing) one if it isn't stored */
+static TTEntry *tt_slot(TransTable *tt, uint64_t key) {
+    TTEntry *b = tt_bucket(tt, key);
+    if (b[0].key == key) return &b[0];
+    if (b[1].key == key) return &b[1];
+    TTEntry *e = (b[0].key == 0) ? &b[0]
+               : (b[1].key == 0) ? &b[1]
+               : (b[0].visits <= b[1].visits) ? &b[0] : &b[1];
+    e->key = key;
+    e->best = 0;
+    e->visits = 0;
+    e->flags = 0;
+    return e;
+}
+
+/* A search passed through this state and finished with `score` */
+void tt_record(TransTable *tt, uint64_t key, int score) {
+    if (!tt || key == 0) return;
+    TTEntry *e = tt_slot(tt, key);
+    if (e->visits == 0 || score > e->best) e->best = score;
+    e->visits++;
+}
+
+void tt_mark_dead(TransTable *tt, uint64_t key) {
+    if (!tt || key == 0) return;
+    tt_slot(tt, key)->flags |= TT_FLAG_DEAD;
+}
+
+/* Dead: explicitly marked, or tried often enough without beating best_so_far */
+bool tt_is_dead(const TransTable *tt, uint64_t key, int best_so_far) {
+    const TTEntry *e = tt_probe(tt, key);
+    if (!e) return false;
+    if (e->flags & TT_FLAG_DEAD) return true;
+    return e->visits >= TT_DEAD_VISITS && e->best <= best_so_far;
+}